@@ -18,19 +18,12 @@
 #include <thread>
 #include <chrono>
 #include <csignal>
+#include <fstream>
 
-// Global atomic flag definition for shutdown
-std::atomic<bool> g_shutdown_requested(false);
-
-// OS signal handler function implementation
-extern "C" void osSignalHandler(int signal)
-{
-    if (signal == SIGINT || signal == SIGTERM)
-    {
-        std::cout << "\nOS Signal Handler: Caught signal " << signal << ". Requesting application shutdown." << std::endl;
-        g_shutdown_requested.store(true);
-    }
-}
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
 
 template <typename ConcreteApp>
 Application<ConcreteApp>::Application(const std::string &appName)
@@ -40,26 +33,68 @@ Application<ConcreteApp>::Application(const std::string &appName)
 {
     std::cout << appName_ << ": Application constructor." << std::endl;
     addCommonStates(); // Add the predefined common states
+
+    // SIGINT and SIGTERM are read from a signalfd by run(), never delivered asynchronously. They are
+    // only blocked once the signalfd exists, otherwise nothing could stop the application anymore.
+    sigset_t shutdownSignals;
+    sigemptyset(&shutdownSignals);
+    sigaddset(&shutdownSignals, SIGINT);
+    sigaddset(&shutdownSignals, SIGTERM);
+    signalFd_ = signalfd(-1, &shutdownSignals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd_ >= 0)
+    {
+        pthread_sigmask(SIG_BLOCK, &shutdownSignals, nullptr);
+    }
+    else
+    {
+        std::cerr << appName_ << ": Could not create signalfd, SIGINT/SIGTERM keep their default action "
+                  << "and end the application without a graceful shutdown" << std::endl;
+    }
 }
 
 template <typename ConcreteApp>
 Application<ConcreteApp>::~Application()
 {
     std::cout << appName_ << ": Application destructor." << std::endl;
+    signalBus_.unsubscribe(static_cast<ConcreteApp *>(this)); // In case terminate() was never reached
+    if (signalFd_ >= 0)
+    {
+        close(signalFd_);
+    }
 }
 
 template <typename ConcreteApp>
 bool Application<ConcreteApp>::initialize()
 {
     std::cout << appName_ << ": Initializing..." << std::endl;
-    // Register OS signal handler for graceful shutdown
-    std::signal(SIGINT, osSignalHandler);
-    std::signal(SIGTERM, osSignalHandler);
+    if (!reactor_.valid())
+    {
+        std::cerr << appName_ << ": Initialization failed, the event loop could not be created." << std::endl;
+        return false;
+    }
+    // Graceful shutdown on SIGINT/SIGTERM, read from the signalfd by the run loop
+    if (signalFd_ >= 0)
+    {
+        reactor_.watch(signalFd_, EPOLLIN,
+                       [this](std::uint32_t)
+                       {
+                           signalfd_siginfo info;
+                           while (read(signalFd_, &info, sizeof(info)) == sizeof(info))
+                           {
+                               std::cout << "\n" << appName_ << ": Caught signal " << info.ssi_signo
+                                         << ". Requesting application shutdown." << std::endl;
+                               stopRequested_ = true;
+                           }
+                       });
+    }
+    // Samples for DeliveryMode::Polled subscribers are handled on this thread
+    reactor_.watch(signalBus_.pollFd(), EPOLLIN, [this](std::uint32_t) { signalBus_.drainPolled(); });
     // Ignore SIGPIPE to prevent crashes on broken pipes (common in IPC)
     std::signal(SIGPIPE, SIG_IGN);
 
     stateMachine_.handleEvent(AppEvent::INIT_REQUEST); // Trigger state transition
     onInitialize();                                    // Hook for derived class-specific initialization
+    stateMachine_.processPosted();                     // Events it triggered, e.g. INIT_FAIL
 
     // After onInitialize, derived class should trigger INIT_SUCCESS/FAIL
     // If not, we might consider it successful by default if no error occurred
@@ -86,14 +121,38 @@ template <typename ConcreteApp>
 void Application<ConcreteApp>::run()
 {
     std::cout << appName_ << ": Entering main run loop." << std::endl;
-    while (!g_shutdown_requested.load() && stateMachine_.getCurrentState() != AppState::TERMINATED)
+    int executeTimer = -1;
+    if (executePeriod_.count() > 0)
+    {
+        executeTimer = reactor_.addTimer(executePeriod_,
+                                         [this]
+                                         {
+                                             if (stateMachine_.getCurrentState() == AppState::RUNNING)
+                                             {
+                                                 onExecute(); // Hook for derived class's main logic
+                                             }
+                                         });
+    }
+
+    // Sleeps in epoll_wait until a handler has work; no fixed tick
+    while (!stopRequested_ && stateMachine_.getCurrentState() != AppState::TERMINATED)
     {
-        if (stateMachine_.getCurrentState() == AppState::RUNNING)
+        stateMachine_.processPosted(); // Events triggered by other threads
+        if (stopRequested_ || stateMachine_.getCurrentState() == AppState::TERMINATED)
+        {
+            break;
+        }
+        if (!reactor_.runOnce())
         {
-            onExecute(); // Hook for derived class's main logic
+            std::cerr << appName_ << ": Event loop failed, leaving the run loop." << std::endl;
+            stopRequested_ = true;
+            break;
         }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10)); // Adjust tick rate as needed
-        // stateMachine_.handleEvent(AppEvent::TICK);
+    }
+
+    if (executeTimer >= 0)
+    {
+        reactor_.cancelTimer(executeTimer);
     }
     std::cout << appName_ << ": Exiting main run loop." << std::endl;
 }
@@ -114,6 +173,9 @@ void Application<ConcreteApp>::terminate()
         stateMachine_.handleEvent(AppEvent::TICK); // Give states a chance to process termination
     }
 
+    // Queued handlers must not run on an application that is going away
+    signalBus_.unsubscribe(static_cast<ConcreteApp *>(this));
+
     std::cout << appName_ << ": Termination complete. Final state: "
               << static_cast<int>(stateMachine_.getCurrentState()) << std::endl;
 }
@@ -127,7 +189,48 @@ AppState Application<ConcreteApp>::getCurrentApplicationState() const
 template <typename ConcreteApp>
 void Application<ConcreteApp>::triggerApplicationEvent(AppEvent event)
 {
-    stateMachine_.handleEvent(event);
+    stateMachine_.post(event);
+    reactor_.wake();
+}
+
+template <typename ConcreteApp>
+void Application<ConcreteApp>::setExecutePeriod(std::chrono::nanoseconds period)
+{
+    executePeriod_ = period;
+}
+
+template <typename ConcreteApp>
+bool Application<ConcreteApp>::watchFd(int fd, std::uint32_t events, Reactor::Handler handler)
+{
+    return reactor_.watch(fd, events, std::move(handler));
+}
+
+template <typename ConcreteApp>
+void Application<ConcreteApp>::unwatchFd(int fd)
+{
+    reactor_.unwatch(fd);
+}
+
+template <typename ConcreteApp>
+bool Application<ConcreteApp>::writeStateTrace(const std::string &path) const
+{
+    if constexpr (!kStateMachineTrace)
+    {
+        std::cerr << appName_ << ": No state trace, built without STATE_MACHINE_TRACE" << std::endl;
+        return false;
+    }
+
+    std::ofstream out(path);
+    if (!out)
+    {
+        std::cerr << appName_ << ": Could not write state trace to " << path << std::endl;
+        return false;
+    }
+    TransitionTrace::instance().writeChromeTrace(
+        out, [](int state) -> std::string { return appStateName(static_cast<AppState>(state)); },
+        [](int event) -> std::string { return appEventName(static_cast<AppEvent>(event)); });
+    std::cout << appName_ << ": State trace written to " << path << std::endl;
+    return true;
 }
 
 template <typename ConcreteApp>
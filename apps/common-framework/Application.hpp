@@ -20,17 +20,21 @@
 #include "state/StateMachine.hpp"
 #include "state/CommonApplicationStates.hpp"
 #include "signals/SignalBus.hpp"
-#include "signals/ISignal.hpp"
+#include "Reactor.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <string>
-#include <atomic>
-
-// Global atomic flag for shutdown, accessed by the signal handler
-extern std::atomic<bool> g_shutdown_requested;
-
-// OS signal handler function
-extern "C" void osSignalHandler(int signal);
 
+/*
+ * run() is an epoll loop (see Reactor.hpp): it sleeps until SIGINT/SIGTERM
+ * arrive through a signalfd, the execute timer fires, an event is triggered,
+ * a DeliveryMode::Polled subscriber has samples or an fd the application
+ * watches is ready. The constructor blocks SIGINT and SIGTERM so the signalfd
+ * gets them; construct the application before starting other threads, they
+ * inherit the mask. Without a signalfd the signals are left unblocked, and
+ * without an event loop initialize() fails; run() returns if the loop breaks.
+ */
 template <typename ConcreteApp> // Using CRTP (Curiously Recurring Template Pattern) for static_cast safety
 class Application
 {
@@ -38,6 +42,7 @@ protected:
     StateMachine<AppState, AppEvent> stateMachine_;
     SignalBus &signalBus_;
     std::string appName_;
+    Reactor reactor_;
 
 public:
     explicit Application(const std::string &appName);
@@ -48,22 +53,34 @@ public:
     void run();
     void terminate();
 
-    // State Machine Access for Derived Classes
+    // State Machine Access for Derived Classes; events may be triggered from any thread, they are
+    // handled in order on the thread running the application
     AppState getCurrentApplicationState() const;
     void triggerApplicationEvent(AppEvent event);
 
+    // Writes the state transitions so far as Chrome trace JSON; false if the file cannot be written
+    // or the build has no STATE_MACHINE_TRACE
+    bool writeStateTrace(const std::string &path) const;
+
     // Signal Bus Access for Derived Classes
-    template <typename T, typename Class>
-    void subscribeToSignal(const std::string &signalName, Class *instance, void (Class::*method)(const T &))
+    template <auto Method, typename T, typename Class>
+    void subscribeToSignal(Channel<T> channel, Class *instance, const SubscribeOptions &options = {})
     {
         // static_cast ensures that 'this' (the ConcreteApp instance) is correctly passed.
-        signalBus_.subscribe(signalName, static_cast<ConcreteApp *>(instance), method);
+        signalBus_.template subscribe<Method>(channel, static_cast<ConcreteApp *>(instance), options);
+    }
+
+    template <typename T, typename Class>
+    void subscribeToSignal(Channel<T> channel, Class *instance, void (Class::*method)(const T &),
+                           const SubscribeOptions &options = {})
+    {
+        signalBus_.subscribe(channel, static_cast<ConcreteApp *>(instance), method, options);
     }
 
     template <typename T>
-    void publishSignal(const std::string &signalName, const T &signalData)
+    void publishSignal(Channel<T> channel, const T &signalData)
     {
-        signalBus_.publish(signalName, signalData);
+        signalBus_.publish(channel, signalData);
     }
 
 protected:
@@ -72,8 +89,21 @@ protected:
     virtual void onExecute() = 0; // Pure virtual: MUST be implemented by derived applications
     virtual void onTerminate();
 
+    // How often onExecute() runs while RUNNING, 10 ms by default; 0 for applications that only react
+    // to signals and fds. Set it before run().
+    void setExecutePeriod(std::chrono::nanoseconds period);
+
+    // Runs handler on the application's thread whenever fd reports one of events (EPOLLIN, ...)
+    bool watchFd(int fd, std::uint32_t events, Reactor::Handler handler);
+    void unwatchFd(int fd);
+
     // Allows derived classes to add or override state definitions
     virtual void addCommonStates();
+
+private:
+    int signalFd_ = -1;
+    bool stopRequested_ = false;
+    std::chrono::nanoseconds executePeriod_ = std::chrono::milliseconds(10);
 };
 
 #endif // COMMON_FRAMEWORK_APPLICATION_HPP
\ No newline at end of file
@@ -0,0 +1,171 @@
+/* Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Reactor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr int kMaxReadyEvents = 32;
+} // namespace
+
+Reactor::Reactor() : epollFd_(epoll_create1(EPOLL_CLOEXEC)), wakeFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (epollFd_ < 0 || wakeFd_ < 0)
+    {
+        std::cerr << "Reactor Error: Could not create epoll or eventfd: " << std::strerror(errno) << std::endl;
+        return;
+    }
+    watch(wakeFd_, EPOLLIN,
+          [this](std::uint32_t)
+          {
+              std::uint64_t wakeups;
+              [[maybe_unused]] ssize_t got = read(wakeFd_, &wakeups, sizeof(wakeups));
+          });
+}
+
+Reactor::~Reactor()
+{
+    for (int timerFd : timers_)
+    {
+        close(timerFd);
+    }
+    if (wakeFd_ >= 0)
+    {
+        close(wakeFd_);
+    }
+    if (epollFd_ >= 0)
+    {
+        close(epollFd_);
+    }
+}
+
+bool Reactor::valid() const
+{
+    return epollFd_ >= 0 && wakeFd_ >= 0;
+}
+
+bool Reactor::watch(int fd, std::uint32_t events, Handler handler)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    const int op = handlers_.count(fd) != 0 ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+    if (epoll_ctl(epollFd_, op, fd, &event) != 0)
+    {
+        std::cerr << "Reactor Error: Could not watch fd " << fd << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    handlers_[fd] = std::make_shared<Handler>(std::move(handler));
+    return true;
+}
+
+void Reactor::unwatch(int fd)
+{
+    if (handlers_.erase(fd) != 0)
+    {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+int Reactor::addTimer(std::chrono::nanoseconds period, std::function<void()> onTick)
+{
+    const int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+    {
+        std::cerr << "Reactor Error: Could not create timerfd: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    itimerspec spec{};
+    spec.it_interval.tv_sec = static_cast<time_t>(period.count() / 1000000000);
+    spec.it_interval.tv_nsec = static_cast<long>(period.count() % 1000000000);
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) != 0 ||
+        !watch(timerFd, EPOLLIN,
+               [timerFd, onTick = std::move(onTick)](std::uint32_t)
+               {
+                   // Ticks missed while the loop was busy are not made up for
+                   std::uint64_t expirations;
+                   if (read(timerFd, &expirations, sizeof(expirations)) > 0)
+                   {
+                       onTick();
+                   }
+               }))
+    {
+        close(timerFd);
+        return -1;
+    }
+    timers_.push_back(timerFd);
+    return timerFd;
+}
+
+void Reactor::cancelTimer(int timerFd)
+{
+    auto it = std::find(timers_.begin(), timers_.end(), timerFd);
+    if (it != timers_.end())
+    {
+        unwatch(timerFd);
+        close(timerFd);
+        timers_.erase(it);
+    }
+}
+
+void Reactor::wake()
+{
+    const std::uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(wakeFd_, &one, sizeof(one));
+}
+
+bool Reactor::runOnce(int timeoutMs)
+{
+    if (!valid())
+    {
+        return false;
+    }
+
+    epoll_event ready[kMaxReadyEvents];
+    const int count = epoll_wait(epollFd_, ready, kMaxReadyEvents, timeoutMs);
+    if (count < 0)
+    {
+        if (errno == EINTR)
+        {
+            return true;
+        }
+        std::cerr << "Reactor Error: epoll_wait failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        // Looked up again for every fd: an earlier handler may have unwatched it
+        auto it = handlers_.find(ready[i].data.fd);
+        if (it != handlers_.end())
+        {
+            std::shared_ptr<Handler> handler = it->second;
+            (*handler)(ready[i].events);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+/* Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_REACTOR_HPP
+#define COMMON_FRAMEWORK_REACTOR_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * epoll event loop of one thread. Everything that can wake it is a file
+ * descriptor: the fds it watches, its timerfds and an eventfd for wake(), so
+ * the thread sleeps in the kernel until there is work and never polls.
+ */
+class Reactor
+{
+public:
+    // Called with the epoll events that were reported for the fd
+    using Handler = std::function<void(std::uint32_t events)>;
+
+    Reactor();
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+
+    // False if the epoll instance or the wake eventfd could not be created; nothing can be run then
+    bool valid() const;
+
+    // Watches fd for events (EPOLLIN, ...); the fd stays the caller's. False if epoll refuses it.
+    bool watch(int fd, std::uint32_t events, Handler handler);
+    void unwatch(int fd);
+
+    // Calls onTick every period from the loop, first after one period; -1 on error. The timer's
+    // fd is owned by the reactor, pass it to cancelTimer().
+    int addTimer(std::chrono::nanoseconds period, std::function<void()> onTick);
+    void cancelTimer(int timerFd);
+
+    // Any thread, also from an OS signal handler: makes the current or next runOnce() return
+    void wake();
+
+    // Waits up to timeoutMs (< 0: no limit) for a watched fd, a timer or wake(), then runs the
+    // handlers of what is ready; they may watch and unwatch fds themselves. False if the reactor
+    // cannot wait at all (not valid(), or epoll_wait failed); a loop calling it must stop then.
+    bool runOnce(int timeoutMs = -1);
+
+private:
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+    std::vector<int> timers_;
+};
+
+#endif // COMMON_FRAMEWORK_REACTOR_HPP
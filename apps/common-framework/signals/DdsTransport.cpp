@@ -0,0 +1,120 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DdsTransport.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+DdsTransport::DdsTransport(const dds_config &config) : participant_(dds_participant_create(&config))
+{
+    writers_.fill(kNoWriter);
+    for (dds_qos &qos : qos_)
+    {
+        qos.reliability = DDS_BEST_EFFORT;
+    }
+}
+
+DdsTransport::~DdsTransport()
+{
+    shutdown();
+}
+
+void DdsTransport::setQos(SignalId signalId, const dds_qos &qos)
+{
+    if (signalId < kMaxSignals)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        qos_[signalId] = qos;
+    }
+}
+
+void DdsTransport::send(SignalId signalId, const void *payloads, std::size_t size, std::size_t count)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (participant_ == nullptr)
+    {
+        return;
+    }
+    if (writers_[signalId] == kNoWriter)
+    {
+        SignalBus &bus = SignalBus::getInstance();
+        writers_[signalId] = dds_create_writer(participant_, bus.nameOf(signalId).c_str(),
+                                               bus.wireFingerprintOf(signalId), size, &qos_[signalId]);
+        if (writers_[signalId] < 0)
+        {
+            writers_[signalId] = kWriterFailed;
+            std::cerr << "SignalBus Error: No DDS writer for signal " << bus.nameOf(signalId) << std::endl;
+        }
+    }
+    if (writers_[signalId] >= 0)
+    {
+        dds_write(participant_, writers_[signalId], payloads, count);
+    }
+}
+
+void DdsTransport::listen(SignalId signalId, std::size_t size, const LaneOptions & /*lane*/, std::size_t history,
+                          const Receiver &receiver)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (participant_ == nullptr || listening_[signalId])
+    {
+        return;
+    }
+    listening_[signalId] = true;
+
+    // Late joiners get what KEEP_LAST writers still hold, as repairs
+    dds_qos qos = qos_[signalId];
+    if (qos.reliability == DDS_KEEP_LAST)
+    {
+        qos.history = static_cast<std::uint32_t>(std::min<std::size_t>(history, qos.depth));
+    }
+
+    SignalBus &bus = SignalBus::getInstance();
+    listeners_.push_back(std::make_unique<Listener>(Listener{signalId, receiver}));
+    if (dds_create_reader(participant_, bus.nameOf(signalId).c_str(), bus.wireFingerprintOf(signalId), size, &qos,
+                          &DdsTransport::onSample, listeners_.back().get()) < 0)
+    {
+        std::cerr << "SignalBus Error: No DDS reader for signal " << bus.nameOf(signalId) << std::endl;
+    }
+}
+
+void DdsTransport::onSample(void *context, const void *sample, std::size_t size)
+{
+    const Listener *listener = static_cast<const Listener *>(context);
+    listener->receiver(listener->signalId, sample, size);
+}
+
+void DdsTransport::shutdown()
+{
+    dds_participant *participant;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        participant = participant_;
+        participant_ = nullptr;
+    }
+    // Outside the lock: a handler still running on the receive thread may publish
+    dds_participant_destroy(participant);
+}
@@ -0,0 +1,76 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_DDS_TRANSPORT_HPP
+#define COMMON_FRAMEWORK_DDS_TRANSPORT_HPP
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SignalBus.hpp"
+#include "dds.h"
+
+/*
+ * IPC transport reaching other nodes: topics travel over UDP multicast through
+ * the srv/dds participant (see dds.h). Every process of the domain is a peer,
+ * on this host or another; topic name and wire fingerprint must match.
+ *
+ *   dds_config config{};
+ *   config.interface = "127.0.0.1"; // or the address of the vehicle network interface
+ *   IpcBridge::getInstance().setTransport(std::make_unique<DdsTransport>(config));
+ *
+ * Messages from peers are delivered on the participant's receive thread, lane
+ * thread options do not apply to it.
+ */
+class DdsTransport : public IpcTransport
+{
+public:
+    // Without a participant (socket setup failed, reported by the library) messages are dropped
+    explicit DdsTransport(const dds_config &config);
+    ~DdsTransport() override;
+
+    // Reliability of a topic, BEST_EFFORT unless set before its first publish or subscription.
+    // Only KEEP_LAST topics replay history to late joiners, at most depth samples.
+    void setQos(SignalId signalId, const dds_qos &qos);
+
+    void send(SignalId signalId, const void *payloads, std::size_t size, std::size_t count) override;
+    void listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history,
+                const Receiver &receiver) override;
+
+    // Leaves the domain; later sends are dropped
+    void shutdown() override;
+
+private:
+    struct Listener
+    {
+        SignalId signalId;
+        Receiver receiver;
+    };
+    static void onSample(void *context, const void *sample, std::size_t size);
+
+    static constexpr int kNoWriter = -1;
+    static constexpr int kWriterFailed = -2;
+
+    dds_participant *participant_;
+    std::array<int, kMaxSignals> writers_;
+    std::array<dds_qos, kMaxSignals> qos_{};
+    std::array<bool, kMaxSignals> listening_{};
+    std::vector<std::unique_ptr<Listener>> listeners_;
+    std::mutex mutex_; // held while sending too, so shutdown never pulls the participant from under a sender
+};
+
+#endif // COMMON_FRAMEWORK_DDS_TRANSPORT_HPP
@@ -0,0 +1,600 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShmRing.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::uint32_t kRingMagic = 0x5349474EU; // "SIGN"
+constexpr std::uint32_t kRingVersion = 4;
+constexpr std::size_t kCacheLine = 64;
+constexpr int kAttachTimeoutMs = 1000; // how long a half initialized ring may stay so before it counts as stale
+
+std::size_t alignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+std::string shmName(const std::string &topic)
+{
+    std::string name = "/osap-signal-" + topic;
+    for (std::size_t i = 1; i < name.size(); ++i)
+    {
+        if (name[i] == '/')
+        {
+            name[i] = '_';
+        }
+    }
+    return name;
+}
+
+// Shared (not private) futex operations, the word lives in memory mapped by several processes
+void futexWait(const std::atomic<std::uint32_t> &word, std::uint32_t expected, int timeoutMs)
+{
+    struct timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWakeAll(const std::atomic<std::uint32_t> &word)
+{
+    syscall(SYS_futex, reinterpret_cast<const std::uint32_t *>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+std::uint64_t monotonicNs()
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+bool processGone(pid_t pid)
+{
+    return kill(pid, 0) != 0 && errno == ESRCH;
+}
+} // namespace
+
+struct ShmRing::Interest
+{
+    std::atomic<std::int32_t> pid;    // owner, 0 if free
+    std::atomic<std::uint32_t> state; // odd while the fields below are written
+    std::uint32_t all;
+    std::uint32_t count;
+    FieldRange ranges[kMaxInterestRanges];
+};
+
+struct ShmRing::Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t payloadSize;
+    std::uint32_t slotCount; // power of two
+    std::uint32_t slotStride;
+    std::uint64_t fingerprint; // wire schema of the payload
+    std::atomic<std::uint32_t> ready; // set by the creator once the fields above are written
+
+    alignas(kCacheLine) std::atomic<std::uint64_t> head; // next sequence number to claim
+
+    alignas(kCacheLine) std::atomic<std::uint32_t> epoch; // futex word
+    std::atomic<std::uint32_t> sleepers;                  // readers inside futexWait, a crashed one only costs a wake
+
+    alignas(kCacheLine) std::atomic<std::uint32_t> interestVersion; // bumped by every change of the table
+    std::atomic<std::uint32_t> history; // deepest history any process keeps of the topic; the ring holds it, unfiltered
+    std::atomic<std::uint32_t> undeclared; // readers that found the table full, nothing is filtered while > 0
+    Interest interests[kMaxInterests];
+};
+
+struct ShmRing::Slot
+{
+    // 2 * seq + 1 while sequence 'seq' is written, 2 * seq + 2 once it is complete
+    std::atomic<std::uint64_t> state;
+    std::int32_t publisher;
+    std::uint32_t reserved;
+    // payload follows
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "ring words must be lock free to be shared");
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "futex word must be 32 bits");
+
+ShmRing::ShmRing(void *base, std::size_t mappedSize)
+    : header_(static_cast<Header *>(base)), mappedSize_(mappedSize), pid_(getpid())
+{
+}
+
+ShmRing::~ShmRing()
+{
+    withdrawInterest();
+
+    // The object stays for the other processes; the name is reused by the next run
+    munmap(header_, mappedSize_);
+}
+
+std::unique_ptr<ShmRing> ShmRing::open(const std::string &topic, std::size_t payloadSize, std::uint64_t fingerprint,
+                                       std::uint32_t slots)
+{
+    const std::string name = shmName(topic);
+
+    std::uint32_t slotCount = 1;
+    while (slotCount < slots)
+    {
+        slotCount <<= 1;
+    }
+    const std::size_t stride = alignUp(sizeof(Slot) + payloadSize, kCacheLine);
+    const std::size_t headerSize = alignUp(sizeof(Header), kCacheLine);
+    const std::size_t totalSize = headerSize + stride * slotCount;
+
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+        if (fd >= 0)
+        {
+            if (ftruncate(fd, static_cast<off_t>(totalSize)) != 0)
+            {
+                close(fd);
+                shm_unlink(name.c_str());
+                break;
+            }
+            void *base = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            close(fd);
+            if (base == MAP_FAILED)
+            {
+                shm_unlink(name.c_str());
+                break;
+            }
+
+            // ftruncate zero fills, so the atomics start out at 0
+            Header *header = static_cast<Header *>(base);
+            header->magic = kRingMagic;
+            header->version = kRingVersion;
+            header->payloadSize = static_cast<std::uint32_t>(payloadSize);
+            header->slotCount = slotCount;
+            header->slotStride = static_cast<std::uint32_t>(stride);
+            header->fingerprint = fingerprint;
+            header->ready.store(1, std::memory_order_release);
+            return std::unique_ptr<ShmRing>(new ShmRing(base, totalSize));
+        }
+        if (errno != EEXIST)
+        {
+            break;
+        }
+
+        // Created by another process, wait for it to finish initializing
+        fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0660);
+        if (fd < 0)
+        {
+            continue; // unlinked in between, try creating it again
+        }
+
+        struct stat st;
+        void *base = MAP_FAILED;
+        std::size_t mapped = 0;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kAttachTimeoutMs);
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= headerSize)
+            {
+                mapped = static_cast<std::size_t>(st.st_size);
+                base = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        close(fd);
+
+        Header *header = (base != MAP_FAILED) ? static_cast<Header *>(base) : nullptr;
+        while (header != nullptr && header->ready.load(std::memory_order_acquire) == 0 &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (header == nullptr || header->ready.load(std::memory_order_acquire) == 0)
+        {
+            // The creator died half way, replace the ring
+            if (header != nullptr)
+            {
+                munmap(base, mapped);
+            }
+            std::cerr << "SignalBus Warning: Replacing stale shared memory ring for '" << topic << "'" << std::endl;
+            shm_unlink(name.c_str());
+            continue;
+        }
+
+        if (header->magic != kRingMagic || header->version != kRingVersion || header->payloadSize != payloadSize ||
+            mapped < headerSize + static_cast<std::size_t>(header->slotStride) * header->slotCount)
+        {
+            std::cerr << "SignalBus Error: Shared memory ring for '" << topic << "' has an incompatible layout"
+                      << std::endl;
+            munmap(base, mapped);
+            return nullptr;
+        }
+        if (header->fingerprint != fingerprint)
+        {
+            std::cerr << "SignalBus Error: Shared memory ring for '" << topic
+                      << "' was created for another schema version of the signal" << std::endl;
+            munmap(base, mapped);
+            return nullptr;
+        }
+        return std::unique_ptr<ShmRing>(new ShmRing(base, mapped));
+    }
+
+    std::cerr << "SignalBus Error: Could not open shared memory ring for '" << topic << "': " << std::strerror(errno)
+              << std::endl;
+    return nullptr;
+}
+
+std::size_t ShmRing::payloadSize() const
+{
+    return header_->payloadSize;
+}
+
+std::uint32_t ShmRing::slots() const
+{
+    return header_->slotCount;
+}
+
+std::uint64_t ShmRing::head() const
+{
+    return header_->head.load(std::memory_order_acquire);
+}
+
+std::uint32_t ShmRing::epoch() const
+{
+    return header_->epoch.load(std::memory_order_acquire);
+}
+
+ShmRing::Slot *ShmRing::slot(std::uint64_t sequence) const
+{
+    auto *base = reinterpret_cast<unsigned char *>(header_) + alignUp(sizeof(Header), kCacheLine);
+    return reinterpret_cast<Slot *>(base + (sequence & (header_->slotCount - 1)) * header_->slotStride);
+}
+
+void ShmRing::fill(std::uint64_t sequence, const void *payload)
+{
+    Slot *target = slot(sequence);
+
+    // Claimed from a complete earlier lap only: a writer a lap behind or ahead may still hold the slot
+    std::uint64_t state = target->state.load(std::memory_order_relaxed);
+    do
+    {
+        if ((state & 1U) != 0 || state >= 2 * sequence + 1)
+        {
+            // Reported on powers of two only, like a lagging reader
+            const std::uint64_t lost = lostWrites_.fetch_add(1, std::memory_order_relaxed) + 1;
+            if ((lost & (lost - 1)) == 0)
+            {
+                std::cerr << "SignalBus Warning: Writer lapped on a shared memory ring, " << lost << " samples lost"
+                          << std::endl;
+            }
+            return;
+        }
+    } while (!target->state.compare_exchange_weak(state, 2 * sequence + 1, std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+    target->publisher = pid_;
+    std::memcpy(reinterpret_cast<unsigned char *>(target) + sizeof(Slot), payload, header_->payloadSize);
+    target->state.store(2 * sequence + 2, std::memory_order_release);
+}
+
+void ShmRing::wakeReaders()
+{
+    // Pairs with the sleepers increment in wait(): either the reader sees the new epoch or we see the sleeper
+    header_->epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (header_->sleepers.load(std::memory_order_seq_cst) != 0)
+    {
+        futexWakeAll(header_->epoch);
+    }
+}
+
+void ShmRing::write(const void *payload)
+{
+    fill(header_->head.fetch_add(1, std::memory_order_relaxed), payload);
+    wakeReaders();
+}
+
+void ShmRing::writeBatch(const void *payloads, std::size_t count)
+{
+    const std::size_t kept = std::min<std::size_t>(count, header_->slotCount);
+    const auto *newest = static_cast<const unsigned char *>(payloads) + (count - kept) * header_->payloadSize;
+
+    const std::uint64_t first = header_->head.fetch_add(kept, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < kept; ++i)
+    {
+        fill(first + i, newest + i * header_->payloadSize);
+    }
+    wakeReaders();
+}
+
+ShmRing::ReadResult ShmRing::read(Cursor &cursor, void *out, pid_t &publisher) const
+{
+    const Slot *source = slot(cursor.sequence);
+    const std::uint64_t complete = 2 * cursor.sequence + 2;
+
+    std::uint64_t before = source->state.load(std::memory_order_acquire);
+    if (before < complete)
+    {
+        const std::uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (head <= cursor.sequence)
+        {
+            cursor.stalledSinceNs = 0;
+            return ReadResult::Empty;
+        }
+
+        // Claimed but unfinished: wait a while for the writer, unless the claim was already lapped
+        if (head - cursor.sequence < header_->slotCount)
+        {
+            const std::uint64_t now = monotonicNs();
+            if (cursor.stalledSinceNs == 0)
+            {
+                cursor.stalledSinceNs = now;
+            }
+            if (now - cursor.stalledSinceNs < kStalledWriteNs)
+            {
+                return ReadResult::Empty;
+            }
+        }
+    }
+    else if (before == complete)
+    {
+        publisher = source->publisher;
+        std::memcpy(out, reinterpret_cast<const unsigned char *>(source) + sizeof(Slot), header_->payloadSize);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source->state.load(std::memory_order_relaxed) == complete)
+        {
+            ++cursor.sequence;
+            cursor.stalledSinceNs = 0;
+            return ReadResult::Ok;
+        }
+    }
+
+    // Overwritten by a later lap or abandoned by its writer, skip to the oldest sequence that can still be intact
+    const std::uint64_t head = header_->head.load(std::memory_order_acquire);
+    const std::uint64_t oldest = (head > header_->slotCount) ? head - header_->slotCount + 1 : 0;
+    cursor.sequence = (oldest > cursor.sequence) ? oldest : cursor.sequence + 1;
+    cursor.stalledSinceNs = 0;
+    return ReadResult::Overrun;
+}
+
+void ShmRing::wait(std::uint32_t seen, long spinNs, int timeoutMs) const
+{
+    // A short spin catches back to back messages without paying for a futex wake
+    auto spinUntil = std::chrono::steady_clock::now() + std::chrono::nanoseconds(spinNs);
+    while (header_->epoch.load(std::memory_order_acquire) == seen && std::chrono::steady_clock::now() < spinUntil)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    }
+    if (header_->epoch.load(std::memory_order_acquire) != seen)
+    {
+        return;
+    }
+
+    header_->sleepers.fetch_add(1, std::memory_order_seq_cst);
+    futexWait(header_->epoch, seen, timeoutMs);
+    header_->sleepers.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+void ShmRing::wakeAll() const
+{
+    header_->epoch.fetch_add(1, std::memory_order_seq_cst);
+    futexWakeAll(header_->epoch);
+}
+
+void ShmRing::declareInterest(const SignalInterest &interest)
+{
+    std::lock_guard<std::mutex> lock(interestMutex_);
+
+    for (std::size_t i = 0; i < kMaxInterests && interestEntry_ < 0 && !undeclared_; ++i)
+    {
+        // A pid of our own is left from an earlier process that got the same one
+        Interest &entry = header_->interests[i];
+        std::int32_t owner = entry.pid.load(std::memory_order_acquire);
+        if ((owner == 0 || owner == pid_ || processGone(owner)) &&
+            entry.pid.compare_exchange_strong(owner, pid_, std::memory_order_acq_rel))
+        {
+            interestEntry_ = static_cast<int>(i);
+        }
+    }
+    if (interestEntry_ < 0 && !undeclared_)
+    {
+        undeclared_ = true;
+        header_->undeclared.fetch_add(1, std::memory_order_acq_rel);
+        std::cerr << "SignalBus Warning: Too many readers on a shared memory ring, publishers will not filter"
+                  << std::endl;
+    }
+
+    if (interestEntry_ >= 0)
+    {
+        Interest &entry = header_->interests[interestEntry_];
+        const std::uint32_t writing = entry.state.load(std::memory_order_relaxed) | 1U;
+        entry.state.store(writing, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        entry.all = interest.all ? 1U : 0U;
+        entry.count = static_cast<std::uint32_t>(std::min(interest.count, kMaxInterestRanges));
+        std::memcpy(entry.ranges, interest.ranges.data(), sizeof(entry.ranges));
+        entry.state.store(writing + 1, std::memory_order_release);
+    }
+    header_->interestVersion.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ShmRing::withdrawInterest()
+{
+    std::lock_guard<std::mutex> lock(interestMutex_);
+
+    if (interestEntry_ < 0 && !undeclared_)
+    {
+        return;
+    }
+    if (interestEntry_ >= 0)
+    {
+        header_->interests[interestEntry_].pid.store(0, std::memory_order_release);
+        interestEntry_ = -1;
+    }
+    if (undeclared_)
+    {
+        header_->undeclared.fetch_sub(1, std::memory_order_acq_rel);
+        undeclared_ = false;
+    }
+    header_->interestVersion.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ShmRing::keepHistory(std::size_t depth)
+{
+    const auto wanted = static_cast<std::uint32_t>(std::min<std::size_t>(depth, header_->slotCount - 1));
+    std::uint32_t kept = header_->history.load(std::memory_order_relaxed);
+    while (kept < wanted && !header_->history.compare_exchange_weak(kept, wanted, std::memory_order_acq_rel))
+    {
+    }
+}
+
+bool ShmRing::wanted(const void *payload)
+{
+    // Late joiners replay the ring as history, a filtered sample would be a hole in it
+    if (header_->history.load(std::memory_order_relaxed) != 0)
+    {
+        return true;
+    }
+
+    InterestSnapshot *snapshot = pinInterests();
+    bool accepted = snapshot->all;
+    for (std::size_t r = 0; !accepted && r < snapshot->count; ++r)
+    {
+        const SignalInterest &reader = snapshot->readers[r];
+        for (std::size_t i = 0; !accepted && i < reader.count; ++i)
+        {
+            accepted = reader.ranges[i].accepts(payload);
+        }
+    }
+    snapshot->users.fetch_sub(1, std::memory_order_release);
+    return accepted;
+}
+
+ShmRing::InterestSnapshot *ShmRing::pinInterests()
+{
+    for (;;)
+    {
+        InterestSnapshot *snapshot = interests_.load(std::memory_order_acquire);
+        if (snapshot == nullptr)
+        {
+            refreshInterests();
+            continue;
+        }
+
+        // Pairs with the users check in refreshInterests(): either it sees us, or we see it was replaced
+        snapshot->users.fetch_add(1, std::memory_order_seq_cst);
+        if (interests_.load(std::memory_order_seq_cst) != snapshot)
+        {
+            snapshot->users.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+        if (snapshot->version == header_->interestVersion.load(std::memory_order_acquire))
+        {
+            return snapshot;
+        }
+        snapshot->users.fetch_sub(1, std::memory_order_release);
+        refreshInterests();
+    }
+}
+
+void ShmRing::refreshInterests()
+{
+    std::lock_guard<std::mutex> lock(interestMutex_);
+
+    // Another publisher may have refreshed while we waited for the lock
+    InterestSnapshot *current = interests_.load(std::memory_order_relaxed);
+    const std::uint32_t version = header_->interestVersion.load(std::memory_order_acquire);
+    if (current != nullptr && current->version == version)
+    {
+        return;
+    }
+
+    // A retired snapshot no publisher holds anymore; they hold one only while evaluating a sample
+    InterestSnapshot *snapshot = nullptr;
+    while (snapshot == nullptr)
+    {
+        for (InterestSnapshot &candidate : interestSnapshots_)
+        {
+            if (&candidate != current && candidate.users.load(std::memory_order_seq_cst) == 0)
+            {
+                snapshot = &candidate;
+                break;
+            }
+        }
+        if (snapshot == nullptr)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // The version first: a change while the table is copied makes the next publish copy it again
+    snapshot->version = version;
+    snapshot->all = header_->undeclared.load(std::memory_order_acquire) != 0;
+    snapshot->count = 0;
+    bool declared = false;
+
+    for (Interest &entry : header_->interests)
+    {
+        // Our own samples are dispatched in-process, never read back from the ring
+        const std::int32_t owner = entry.pid.load(std::memory_order_acquire);
+        if (owner == 0 || owner == pid_)
+        {
+            continue;
+        }
+        declared = true;
+
+        const std::uint32_t before = entry.state.load(std::memory_order_acquire);
+        SignalInterest interest;
+        interest.all = entry.all != 0;
+        interest.count = std::min<std::size_t>(entry.count, kMaxInterestRanges);
+        std::memcpy(interest.ranges.data(), entry.ranges, sizeof(entry.ranges));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Torn by a writer, or nonsense from a crashed one: the reader gets everything
+        bool valid = (before & 1U) == 0 && entry.state.load(std::memory_order_relaxed) == before;
+        for (std::size_t i = 0; valid && i < interest.count; ++i)
+        {
+            const FieldRange &range = interest.ranges[i];
+            valid = range.scalar <= WireScalar::Double && range.offset + range.fieldSize() <= header_->payloadSize;
+        }
+        if (!valid || interest.all)
+        {
+            snapshot->all = true;
+        }
+        else if (interest.count > 0)
+        {
+            snapshot->readers[snapshot->count++] = interest;
+        }
+    }
+    snapshot->all = snapshot->all || !declared;
+
+    interests_.store(snapshot, std::memory_order_seq_cst);
+}
@@ -0,0 +1,152 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SHM_RING_HPP
+#define COMMON_FRAMEWORK_SHM_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <sys/types.h>
+
+#include "SignalFilter.hpp"
+
+/*
+ * Broadcast ring of fixed size slots in POSIX shared memory, one per topic.
+ *
+ * Publishers claim a sequence number and write the payload straight into its
+ * slot; the slot's own sequence word works as a seqlock, so readers validate
+ * what they copied out. Readers keep their cursor in their own process and
+ * writers never wait for them: a slow reader is lapped and told so, a crashed
+ * one holds nothing the others depend on.
+ *
+ * Reading processes declare which samples they want in the ring's header, and
+ * publishers skip the samples no other process wants (see SignalFilter.hpp),
+ * except on topics with history, where every sample is written.
+ */
+class ShmRing
+{
+public:
+    static constexpr std::uint32_t kDefaultSlots = 64;
+    static constexpr std::uint64_t kStalledWriteNs = 50'000'000; // far beyond a payload copy, short of a reader's wakeup period
+
+    enum class ReadResult
+    {
+        Ok,      // payload copied, cursor advanced
+        Empty,   // nothing published at the cursor yet, or its writer is still copying
+        Overrun, // the reader was lapped or the slot's writer stalled, cursor moved past it
+    };
+
+    // A reader's position, kept in its own process
+    struct Cursor
+    {
+        std::uint64_t sequence = 0;
+        std::uint64_t stalledSinceNs = 0; // when the slot at sequence was first seen claimed but unfinished
+    };
+
+    // Creates the topic's ring or attaches to the one another process created. nullptr if shared
+    // memory is unavailable or the existing ring carries another wire schema (see WireSchema.hpp).
+    static std::unique_ptr<ShmRing> open(const std::string &topic, std::size_t payloadSize, std::uint64_t fingerprint,
+                                         std::uint32_t slots = kDefaultSlots);
+    ~ShmRing();
+
+    ShmRing(const ShmRing &) = delete;
+    ShmRing &operator=(const ShmRing &) = delete;
+
+    std::size_t payloadSize() const;
+    std::uint32_t slots() const;
+
+    // Sequence number the next write will get; a new reader starts here
+    std::uint64_t head() const;
+
+    // Copies the payload into the next slot and wakes sleeping readers. A slot another writer is still
+    // filling a lap away is left to it; the sample is lost and counted, its readers see an overrun.
+    void write(const void *payload);
+
+    // Writes count payloads laid out back to back, claiming their slots at once and waking readers
+    // once. Only the newest slot count of them can survive in the ring, older ones are skipped.
+    void writeBatch(const void *payloads, std::size_t count);
+
+    // Copies the slot at cursor into out (payloadSize() bytes) and reports who published it. A slot
+    // claimed but left unfinished by a writer that died or stalled is skipped as an overrun once it
+    // has been seen that way for kStalledWriteNs, so later samples are not held back until the next lap.
+    ReadResult read(Cursor &cursor, void *out, pid_t &publisher) const;
+
+    // Futex word bumped by every write; read it before draining, then wait on it
+    std::uint32_t epoch() const;
+
+    // Spins for up to spinNs, then sleeps until the epoch moves past 'seen' or timeoutMs passed
+    void wait(std::uint32_t seen, long spinNs, int timeoutMs) const;
+
+    // Wakes every reader sleeping on the ring, e.g. to let it notice a shutdown
+    void wakeAll() const;
+
+    // Declares or replaces what this process reads from the ring, until withdrawn or the ring is closed.
+    // An entry left by a crashed process is taken over by the next one needing it.
+    void declareInterest(const SignalInterest &interest);
+    void withdrawInterest();
+
+    // Marks the ring as the topic's history (up to depth samples), for good: its publishers stop filtering,
+    // so a late or restarted reader replays every sample, not just those the current readers wanted
+    void keepHistory(std::size_t depth);
+
+    // Whether another process declared an interest in the payload; true as long as none declared any,
+    // so the ring keeps the history for readers still to come, and always on a ring keeping history
+    bool wanted(const void *payload);
+
+private:
+    struct Header;
+    struct Slot;
+    struct Interest;
+
+    static constexpr std::size_t kMaxInterests = 16;     // reading processes per ring that can declare what they want
+    static constexpr std::size_t kInterestSnapshots = 3; // the current one plus ones publishers may still be reading
+
+    // Interests of the other processes as of one version of the table. Preallocated and reused once no
+    // publisher holds it, so a changing table costs no allocation and no memory growth on the publish path.
+    struct InterestSnapshot
+    {
+        std::atomic<std::uint32_t> users{0}; // publishers evaluating it right now
+        std::uint32_t version = 0;
+        bool all = true;
+        std::size_t count = 0;
+        std::array<SignalInterest, kMaxInterests> readers{};
+    };
+
+    ShmRing(void *base, std::size_t mappedSize);
+    Slot *slot(std::uint64_t sequence) const;
+    void fill(std::uint64_t sequence, const void *payload);
+    void wakeReaders();
+    InterestSnapshot *pinInterests();
+    void refreshInterests();
+
+    Header *header_;
+    std::size_t mappedSize_;
+    pid_t pid_;
+
+    std::array<InterestSnapshot, kInterestSnapshots> interestSnapshots_;
+    std::atomic<InterestSnapshot *> interests_{nullptr}; // current one, nullptr until first needed
+    std::atomic<std::uint64_t> lostWrites_{0}; // samples not written, their slot was still held a lap away
+    int interestEntry_ = -1;   // index into the header's table, -1 if none is held
+    bool undeclared_ = false;  // no entry was free, counted in the header instead
+    std::mutex interestMutex_;
+};
+
+#endif // COMMON_FRAMEWORK_SHM_RING_HPP
@@ -0,0 +1,217 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ShmTransport.hpp"
+#include "ShmRing.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include <unistd.h>
+
+namespace
+{
+constexpr long kReaderSpinNs = 20000;   // busy wait before a reader sleeps on the futex
+constexpr int kReaderWakeupMs = 100;    // upper bound on a sleep, so shutdown is noticed
+} // namespace
+
+ShmTransport::ShmTransport() = default;
+
+ShmTransport::~ShmTransport()
+{
+    shutdown();
+}
+
+ShmRing *ShmTransport::ring(SignalId signalId, std::size_t size)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return nullptr;
+    }
+
+    ShmRing *ring = rings_[signalId].load(std::memory_order_acquire);
+    if (ring != nullptr)
+    {
+        return ring;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ring = rings_[signalId].load(std::memory_order_relaxed);
+    if (ring == nullptr && !ringFailed_[signalId])
+    {
+        // Peers attach only if they were built against the same wire schema
+        SignalBus &bus = SignalBus::getInstance();
+        ownedRings_[signalId] = ShmRing::open(bus.nameOf(signalId), size, bus.wireFingerprintOf(signalId));
+        ring = ownedRings_[signalId].get();
+        ringFailed_[signalId] = (ring == nullptr);
+        rings_[signalId].store(ring, std::memory_order_release);
+    }
+    return ring;
+}
+
+void ShmTransport::send(SignalId signalId, const void *payloads, std::size_t size, std::size_t count)
+{
+    ShmRing *target = ring(signalId, size);
+    if (target == nullptr || target->payloadSize() != size)
+    {
+        return;
+    }
+    // A topic with history here keeps it in the ring for the other processes too
+    const std::size_t history = SignalBus::getInstance().historyOf(signalId);
+    if (history > 0)
+    {
+        target->keepHistory(history);
+    }
+    if (count == 1)
+    {
+        if (target->wanted(payloads))
+        {
+            target->write(payloads);
+        }
+        return;
+    }
+
+    // Most batches are wanted whole; otherwise the wanted samples are gathered first
+    const auto *first = static_cast<const unsigned char *>(payloads);
+    std::size_t unwanted = 0;
+    while (unwanted < count && target->wanted(first + unwanted * size))
+    {
+        ++unwanted;
+    }
+    if (unwanted == count)
+    {
+        target->writeBatch(payloads, count);
+        return;
+    }
+
+    thread_local std::vector<unsigned char> gathered;
+    gathered.assign(first, first + unwanted * size);
+    for (std::size_t i = unwanted + 1; i < count; ++i)
+    {
+        if (target->wanted(first + i * size))
+        {
+            gathered.insert(gathered.end(), first + i * size, first + (i + 1) * size);
+        }
+    }
+    if (!gathered.empty())
+    {
+        target->writeBatch(gathered.data(), gathered.size() / size);
+    }
+}
+
+void ShmTransport::listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history,
+                          const Receiver &receiver)
+{
+    ShmRing *source = ring(signalId, size);
+    if (source == nullptr)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!listening_[signalId] && running_.load(std::memory_order_relaxed))
+    {
+        listening_[signalId] = true;
+        source->declareInterest(SignalInterest{}); // everything, until the bus narrows it
+        if (history > 0)
+        {
+            source->keepHistory(history);
+        }
+
+        // One slot short of a lap, the oldest one may be rewritten while we read it
+        const std::uint64_t head = source->head();
+        const std::uint64_t backlog = std::min<std::uint64_t>({history, source->slots() - 1, head});
+        readers_.emplace_back(&ShmTransport::readLoop, this, signalId, source, head - backlog, receiver);
+        configureThread(readers_.back(), "ipc-" + SignalBus::getInstance().nameOf(signalId), lane);
+    }
+}
+
+void ShmTransport::readLoop(SignalId signalId, ShmRing *source, std::uint64_t start, Receiver receiver)
+{
+    ShmRing::Cursor cursor;
+    cursor.sequence = start;
+    const pid_t self = getpid();
+    const std::size_t size = source->payloadSize();
+    // max_align_t storage so handlers may read the payload as their signal type
+    std::unique_ptr<std::max_align_t[]> payload(
+        new std::max_align_t[(size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)]);
+    std::uint64_t overruns = 0;
+    SignalBus &bus = SignalBus::getInstance();
+
+    while (running_.load(std::memory_order_acquire))
+    {
+        const std::uint32_t seen = source->epoch();
+        pid_t publisher = 0;
+        ShmRing::ReadResult result;
+
+        // Only the newest message of a conflated topic matters, the ones before it are not a backlog
+        const std::uint64_t head = source->head();
+        if (bus.isConflated(signalId) && head > cursor.sequence + 1)
+        {
+            cursor.sequence = head - 1;
+            cursor.stalledSinceNs = 0;
+        }
+
+        while ((result = source->read(cursor, payload.get(), publisher)) != ShmRing::ReadResult::Empty)
+        {
+            if (result == ShmRing::ReadResult::Overrun)
+            {
+                // Reported on powers of two only, a reader that keeps falling behind must not flood the log
+                ++overruns;
+                if ((overruns & (overruns - 1)) == 0)
+                {
+                    std::cerr << "[IPC Bridge] Reader lagging on signal " << bus.nameOf(signalId)
+                              << ", " << overruns << " overruns" << std::endl;
+                }
+            }
+            else if (publisher != self) // Own messages were already dispatched in-process
+            {
+                receiver(signalId, payload.get(), size);
+            }
+        }
+        source->wait(seen, kReaderSpinNs, kReaderWakeupMs);
+    }
+}
+
+void ShmTransport::setInterest(SignalId signalId, const SignalInterest &interest)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (signalId < kMaxSignals && listening_[signalId] && running_.load(std::memory_order_relaxed))
+    {
+        ownedRings_[signalId]->declareInterest(interest);
+    }
+}
+
+void ShmTransport::shutdown()
+{
+    std::vector<std::thread> readers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.store(false, std::memory_order_release);
+        readers.swap(readers_);
+        for (SignalId signalId = 0; signalId < kMaxSignals; ++signalId)
+        {
+            if (listening_[signalId])
+            {
+                ownedRings_[signalId]->withdrawInterest();
+                ownedRings_[signalId]->wakeAll();
+            }
+        }
+    }
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+}
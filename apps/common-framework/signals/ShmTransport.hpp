@@ -0,0 +1,66 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SHM_TRANSPORT_HPP
+#define COMMON_FRAMEWORK_SHM_TRANSPORT_HPP
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "SignalBus.hpp"
+
+class ShmRing;
+
+/*---Default IPC transport between processes of one host: one shared memory ring per topic (see ShmRing.hpp)---*/
+class ShmTransport : public IpcTransport
+{
+public:
+    ShmTransport();
+    ~ShmTransport() override;
+
+    // Writes into the topic's ring what other processes want of it; the ring is opened on first use
+    void send(SignalId signalId, const void *payloads, std::size_t size, std::size_t count) override;
+
+    // Starts a reader thread running with the priority and affinity of the topic's lane. The ring
+    // outlives the processes using it, so history is there after a restart too, up to its slot count.
+    void listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history,
+                const Receiver &receiver) override;
+
+    // Declared in the topic's ring, so publishers in other processes skip the samples we do not want,
+    // unless the topic keeps history
+    void setInterest(SignalId signalId, const SignalInterest &interest) override;
+
+    // Stops and joins the reader threads
+    void shutdown() override;
+
+private:
+    ShmRing *ring(SignalId signalId, std::size_t size);
+    void readLoop(SignalId signalId, ShmRing *ring, std::uint64_t start, Receiver receiver);
+
+    // Rings by topic, opened once and kept until the transport is destroyed; senders read them without a lock
+    std::array<std::atomic<ShmRing *>, kMaxSignals> rings_{};
+    std::array<std::unique_ptr<ShmRing>, kMaxSignals> ownedRings_;
+    std::array<bool, kMaxSignals> ringFailed_{};
+    std::array<bool, kMaxSignals> listening_{};
+    std::vector<std::thread> readers_;
+    std::atomic<bool> running_{true};
+    std::mutex mutex_;
+};
+
+#endif // COMMON_FRAMEWORK_SHM_TRANSPORT_HPP
@@ -14,17 +14,39 @@
  */
 
 #include "SignalBus.hpp"
+#include "ShmTransport.hpp"
 #include <iostream>
 
-// --- CONCEPTUAL IPC LAYER IMPLEMENTATION ---
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace
+{
+// Small per-thread number, handed out in the order threads first publish
+std::size_t threadStripe()
+{
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t stripe = next.fetch_add(1, std::memory_order_relaxed);
+    return stripe;
+}
+} // namespace
+
+// --- IPC LAYER IMPLEMENTATION ---
 IpcBridge &IpcBridge::getInstance()
 {
     static IpcBridge instance;
     return instance;
 }
 
-IpcBridge::IpcBridge() = default;
-IpcBridge::~IpcBridge() = default;
+IpcBridge::IpcBridge()
+{
+    setTransport(std::make_unique<ShmTransport>());
+}
+
+IpcBridge::~IpcBridge()
+{
+    shutdown();
+}
 
 void IpcBridge::registerIpcReceiver(IpcSignalReceiver receiver)
 {
@@ -32,22 +54,97 @@ void IpcBridge::registerIpcReceiver(IpcSignalReceiver receiver)
     std::cout << "[IPC Bridge] Receiver registered." << std::endl;
 }
 
-void IpcBridge::sendSignal(const std::string &signalName, const ISignal &signalData)
+void IpcBridge::setTransport(std::unique_ptr<IpcTransport> transport)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    transport_.store(transport.get(), std::memory_order_release);
+    transports_.push_back(std::move(transport));
+}
+
+void IpcBridge::sendSignal(SignalId signalId, const void *payload, std::size_t size)
+{
+    transport_.load(std::memory_order_acquire)->send(signalId, payload, size, 1);
+}
+
+void IpcBridge::sendBatch(SignalId signalId, const void *payloads, std::size_t size, std::size_t count)
+{
+    transport_.load(std::memory_order_acquire)->send(signalId, payloads, size, count);
+}
+
+void IpcBridge::listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history)
 {
-    // In a real system, this would involve serialization and actual IPC send.
-    // For demo, we just print.
-    std::cout << "[IPC Bridge] Sending signal: " << signalName << std::endl;
+    transport_.load(std::memory_order_acquire)
+        ->listen(signalId, size, lane, history,
+                 [this](SignalId id, const void *payload, std::size_t payloadSize)
+                 {
+                     if (ipcReceiver_)
+                     {
+                         ipcReceiver_(id, payload, payloadSize);
+                     }
+                 });
 }
 
-void IpcBridge::receiveAndDispatch(const std::string &signalName, const ISignal &signalData)
+void IpcBridge::setInterest(SignalId signalId, const SignalInterest &interest)
+{
+    transport_.load(std::memory_order_acquire)->setInterest(signalId, interest);
+}
+
+void IpcBridge::shutdown()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &transport : transports_)
+    {
+        transport->shutdown();
+    }
+}
+
+void IpcBridge::receiveAndDispatch(SignalId signalId, const void *payload, std::size_t size)
 {
     if (ipcReceiver_)
     {
-        std::cout << "[IPC Bridge] Received and dispatching signal: " << signalName << std::endl;
-        ipcReceiver_(signalName, signalData);
+        std::cout << "[IPC Bridge] Received and dispatching signal: " << SignalBus::getInstance().nameOf(signalId)
+                  << std::endl;
+        ipcReceiver_(signalId, payload, size);
     }
 }
-// --- END CONCEPTUAL IPC LAYER IMPLEMENTATION ---
+
+void IpcBridge::receiveAndDispatch(const std::string &signalName, const void *payload, std::size_t size)
+{
+    receiveAndDispatch(SignalBus::getInstance().intern(signalName), payload, size);
+}
+// --- END IPC LAYER IMPLEMENTATION ---
+
+// --- SIGNAL BATCH IMPLEMENTATION ---
+void SignalBatch::clear()
+{
+    runs_.clear();
+    used_ = 0;
+}
+
+void SignalBatch::append(SignalId signalId, const void *payload, std::size_t size)
+{
+    constexpr std::size_t kAlign = sizeof(std::max_align_t);
+
+    // Payloads of one run are packed like an array of the signal type, each run starts aligned
+    const bool extends = !runs_.empty() && runs_.back().signalId == signalId && runs_.back().size == size;
+    const std::size_t offset = extends ? used_ : (used_ + kAlign - 1) / kAlign * kAlign;
+    if (offset + size > storage_.size() * kAlign)
+    {
+        storage_.resize(std::max(storage_.size() * 2, (offset + size + kAlign - 1) / kAlign));
+    }
+
+    std::memcpy(reinterpret_cast<unsigned char *>(storage_.data()) + offset, payload, size);
+    used_ = offset + size;
+    if (extends)
+    {
+        ++runs_.back().count;
+    }
+    else
+    {
+        runs_.push_back(Run{signalId, size, 1, offset});
+    }
+}
+// --- END SIGNAL BATCH IMPLEMENTATION ---
 
 // --- SIGNAL BUS IMPLEMENTATION ---
 SignalBus &SignalBus::getInstance()
@@ -56,26 +153,645 @@ SignalBus &SignalBus::getInstance()
     return instance;
 }
 
-SignalBus::SignalBus()
+SignalBus::SignalBus() : pollFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
 {
+    if (pollFd_ < 0)
+    {
+        std::cerr << "SignalBus Error: Could not create the eventfd of polled subscribers" << std::endl;
+    }
+
+    for (auto &priority : priorities_)
+    {
+        priority.store(SignalPriority::Normal, std::memory_order_relaxed);
+    }
+
     IpcBridge::getInstance().registerIpcReceiver(
-        [this](const std::string &signalName, const ISignal &signalData)
+        [this](SignalId signalId, const void *payload, std::size_t size)
         {
-            this->dispatchInternal(signalName, signalData);
+            this->dispatchExternal(signalId, payload, size);
         });
 }
 
-SignalBus::~SignalBus() = default;
+SignalBus::~SignalBus()
+{
+    // Reader threads call into the bus, stop them before it goes away
+    IpcBridge::getInstance().shutdown();
+
+    // Then the queues: release blocked publishers and join the threads calling handlers
+    for (auto &subscription : asyncSubscriptions_)
+    {
+        subscription->queue->stop();
+    }
+    workerPool_.reset();
+    if (pollFd_ >= 0)
+    {
+        close(pollFd_);
+    }
+}
+
+SignalId SignalBus::intern(std::string_view signalName)
+{
+    return intern(signalName, signalNameHash(signalName));
+}
+
+SignalId SignalBus::intern(std::string_view signalName, std::uint64_t nameHash)
+{
+    std::lock_guard<std::mutex> lock(registryMutex_);
+
+    auto it = idsByHash_.find(nameHash);
+    if (it != idsByHash_.end())
+    {
+        if (names_[it->second] != signalName)
+        {
+            std::cerr << "SignalBus Error: Signal name '" << signalName << "' collides with '" << names_[it->second]
+                      << "'" << std::endl;
+            return kInvalidSignalId;
+        }
+        return it->second;
+    }
+
+    std::size_t count = numSignals_.load(std::memory_order_relaxed);
+    if (count >= kMaxSignals)
+    {
+        std::cerr << "SignalBus Error: Too many signals, cannot register '" << signalName << "'" << std::endl;
+        return kInvalidSignalId;
+    }
+
+    SignalId signalId = static_cast<SignalId>(count);
+    names_[signalId] = signalName;
+    idsByHash_.emplace(nameHash, signalId);
+    numSignals_.store(count + 1, std::memory_order_release);
+    return signalId;
+}
+
+const std::string &SignalBus::nameOf(SignalId signalId) const
+{
+    static const std::string unknown = "<unknown>";
+    return (signalId < numSignals_.load(std::memory_order_acquire)) ? names_[signalId] : unknown;
+}
+
+std::uint64_t SignalBus::wireFingerprintOf(SignalId signalId)
+{
+    std::lock_guard<std::mutex> lock(registryMutex_);
+    return (signalId < kMaxSignals) ? fingerprints_[signalId] : 0;
+}
+
+bool SignalBus::bindType(SignalId signalId, const void *typeKey, std::size_t size, std::uint64_t fingerprint)
+{
+    std::lock_guard<std::mutex> lock(registryMutex_);
+
+    if (signalId >= numSignals_.load(std::memory_order_relaxed))
+    {
+        std::cerr << "SignalBus Error: Invalid signal ID " << signalId << std::endl;
+        return false;
+    }
+    if (types_[signalId] == nullptr)
+    {
+        types_[signalId] = typeKey;
+        fingerprints_[signalId] = fingerprint;
+        payloadSizes_[signalId].store(size, std::memory_order_release);
+    }
+    else if (types_[signalId] != typeKey)
+    {
+        std::cerr << "SignalBus Error: Type mismatch for signal " << names_[signalId] << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SignalBus::setWorkerPoolSize(std::size_t threads)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    workerPoolSize_ = threads;
+}
+
+void SignalBus::configureLane(SignalPriority lane, const LaneOptions &options)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    laneOptions_[static_cast<std::size_t>(lane)] = options;
+}
+
+void SignalBus::setPriority(SignalId signalId, SignalPriority priority)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    priorities_[signalId].store(priority, std::memory_order_relaxed);
+    for (auto &subscription : asyncSubscriptions_)
+    {
+        if (subscription->signalId == signalId)
+        {
+            subscription->queue->setLane(priority);
+        }
+    }
+}
+
+SignalPriority SignalBus::priorityOf(SignalId signalId) const
+{
+    return (signalId < kMaxSignals) ? priorities_[signalId].load(std::memory_order_relaxed) : SignalPriority::Normal;
+}
+
+void SignalBus::setConflated(SignalId signalId, bool conflated)
+{
+    if (signalId < kMaxSignals)
+    {
+        conflated_[signalId].store(conflated, std::memory_order_relaxed);
+    }
+}
+
+bool SignalBus::isConflated(SignalId signalId) const
+{
+    return signalId < kMaxSignals && conflated_[signalId].load(std::memory_order_relaxed);
+}
+
+void SignalBus::setHistory(SignalId signalId, std::size_t size, std::size_t depth)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (histories_[signalId].load(std::memory_order_relaxed) != nullptr)
+    {
+        std::cerr << "SignalBus Error: History of signal " << nameOf(signalId) << " is already set" << std::endl;
+        return;
+    }
+    ownedHistories_.push_back(std::make_unique<SignalHistory>(size, depth));
+    histories_[signalId].store(ownedHistories_.back().get(), std::memory_order_release);
+}
+
+std::size_t SignalBus::historyOf(SignalId signalId) const
+{
+    const SignalHistory *history =
+        (signalId < kMaxSignals) ? histories_[signalId].load(std::memory_order_acquire) : nullptr;
+    return (history != nullptr) ? history->depth() : 0;
+}
+
+void SignalBus::unsubscribe(const void *instance)
+{
+    std::vector<DeliveryQueue *> stopped;
+    std::vector<SignalId> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        for (auto &subscription : asyncSubscriptions_)
+        {
+            if (subscription->target.instance == instance)
+            {
+                stopped.push_back(subscription->queue.get());
+            }
+        }
+        metrics_.deactivate(instance);
+        auto removed = [&](const Subscriber &subscriber)
+        {
+            return subscriber.instance == instance ||
+                   std::find(stopped.begin(), stopped.end(), subscriber.instance) != stopped.end();
+        };
+
+        for (std::size_t signalId = 0; signalId < kMaxSignals; ++signalId)
+        {
+            const SubscriberList *current = subscribers_[signalId].load(std::memory_order_relaxed);
+            if (current == nullptr || std::none_of(current->begin(), current->end(), removed))
+            {
+                continue;
+            }
+            auto next = std::make_unique<SubscriberList>(*current);
+            next->erase(std::remove_if(next->begin(), next->end(), removed), next->end());
+            replaceSubscribers(static_cast<SignalId>(signalId), std::move(next));
+            changed.push_back(static_cast<SignalId>(signalId));
+        }
+    }
+
+    // Outside the lock, a handler being waited for may subscribe
+    for (DeliveryQueue *queue : stopped)
+    {
+        queue->stop();
+    }
+    for (SignalId signalId : changed)
+    {
+        updateInterest(signalId);
+    }
+}
+
+void SignalBus::deliverQueued(const void *context, const void *payload, std::int64_t queuedAtNs)
+{
+    getInstance().deliver(*static_cast<const Subscriber *>(context), payload, queuedAtNs);
+}
+
+void SignalBus::deliver(const Subscriber &subscriber, const void *payload, std::int64_t queuedAtNs)
+{
+    if (subscriber.metricsId == kNoMetrics)
+    {
+        subscriber.invoke(subscriber, payload);
+        return;
+    }
+    const std::int64_t start = SignalMetrics::now();
+    subscriber.invoke(subscriber, payload);
+    metrics_.countDelivery(subscriber.metricsId, SignalMetrics::now() - start,
+                           (queuedAtNs < 0) ? -1 : start - queuedAtNs);
+}
+
+// Called with mutex_ held
+SignalBus::Subscriber SignalBus::makeQueued(SignalId signalId, const Subscriber &target,
+                                            const SubscribeOptions &options)
+{
+    WorkerPool *pool = nullptr;
+    if (options.mode == DeliveryMode::Pool)
+    {
+        if (!workerPool_)
+        {
+            workerPool_ = std::make_unique<WorkerPool>(workerPoolSize_, laneOptions_);
+        }
+        pool = workerPool_.get();
+    }
+
+    // A conflated topic's subscriber holds at most its latest value, however slow it is
+    SubscribeOptions queueOptions = options;
+    if (isConflated(signalId))
+    {
+        queueOptions.queueCapacity = 1;
+        queueOptions.overflow = OverflowPolicy::Coalesce;
+    }
+    else if (options.mode == DeliveryMode::Polled && options.overflow == OverflowPolicy::Block)
+    {
+        // The polling thread usually publishes too, blocking it on its own queue would never end
+        std::cerr << "SignalBus Warning: Polled subscriber of " << nameOf(signalId)
+                  << " cannot block, dropping the oldest sample instead" << std::endl;
+        queueOptions.overflow = OverflowPolicy::DropOldest;
+    }
+
+    const SignalPriority lane = priorityOf(signalId);
+    auto subscription = std::make_unique<AsyncSubscription>();
+    subscription->signalId = signalId;
+    subscription->target = target;
+    subscription->queue =
+        std::make_unique<DeliveryQueue>(&SignalBus::deliverQueued, &subscription->target,
+                                        payloadSizes_[signalId].load(std::memory_order_acquire), queueOptions, pool, lane);
+    if (options.mode == DeliveryMode::Dedicated)
+    {
+        subscription->queue->startDedicated("sig-" + nameOf(signalId), laneOptions_[static_cast<std::size_t>(lane)]);
+    }
+    else if (options.mode == DeliveryMode::Polled)
+    {
+        subscription->queue->notifyThrough(pollFd_);
+        polled_.push_back(subscription->queue.get());
+    }
+
+    Subscriber poster{};
+    poster.filter = target.filter;
+    poster.invoke = [](const Subscriber &self, const void *payload)
+    {
+        static_cast<DeliveryQueue *>(self.instance)->post(payload);
+    };
+    poster.invokeBatch = [](const Subscriber &self, const void *payloads, std::size_t count)
+    {
+        static_cast<DeliveryQueue *>(self.instance)->postBatch(payloads, count);
+    };
+    poster.instance = subscription->queue.get();
+    asyncSubscriptions_.push_back(std::move(subscription));
+    return poster;
+}
+
+void SignalBus::addSubscriber(SignalId signalId, const Subscriber &subscriber, const SubscribeOptions &options)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    if (options.filter.fingerprint() != 0 && options.filter.fingerprint() != wireFingerprintOf(signalId))
+    {
+        std::cerr << "SignalBus Error: Filter does not match the payload type of signal " << nameOf(signalId)
+                  << std::endl;
+        return;
+    }
+
+    Subscriber counted = subscriber;
+    counted.metricsId = metrics_.addSubscriber(signalId, nameOf(signalId), subscriber.instance, options.mode,
+                                               options.budget);
+    counted.filter = options.filter;
+    const std::size_t size = payloadSizes_[signalId].load(std::memory_order_acquire);
+    std::vector<std::max_align_t> replay;
+    std::size_t replayCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (counted.filter.kind() == SubscriptionFilter::Kind::Deadband)
+        {
+            counted.filter.last_ = &deadbands_.emplace_back(std::numeric_limits<double>::quiet_NaN());
+        }
+
+        SignalHistory *history = histories_[signalId].load(std::memory_order_acquire);
+        const SubscriberList *current = subscribers_[signalId].load(std::memory_order_relaxed);
+        auto next =
+            (current != nullptr) ? std::make_unique<SubscriberList>(*current) : std::make_unique<SubscriberList>();
+        next->push_back((options.mode == DeliveryMode::Inline) ? counted : makeQueued(signalId, counted, options));
+        const Subscriber added = next->back();
+        auto *queue = (options.mode == DeliveryMode::Inline) ? nullptr : static_cast<DeliveryQueue *>(added.instance);
+        if (history != nullptr && queue != nullptr)
+        {
+            // Live samples posted from the swap on wait in the queue until the replay is in front of them
+            queue->hold();
+        }
+        const std::uint64_t generation = replaceSubscribers(signalId, std::move(next));
+
+        // Samples whose publishers loaded the new list reach the subscriber live, the others are replayed
+        if (history != nullptr && queue == nullptr)
+        {
+            replayCount = keepAccepted(counted.filter, replay, history->copyMissed(replay, generation), size);
+        }
+        else if (history != nullptr)
+        {
+            const std::size_t count = keepAccepted(added.filter, replay, history->copyMissed(replay, generation), size);
+            queue->release(replay.data(), count);
+        }
+    }
+    std::cout << "SignalBus: Subscribed to '" << nameOf(signalId) << "'" << std::endl;
+
+    // Inline handlers run outside the locks, they may publish; live samples from other threads can overtake
+    for (std::size_t i = 0; i < replayCount; ++i)
+    {
+        deliver(counted, reinterpret_cast<const unsigned char *>(replay.data()) + i * size);
+    }
+
+    // Also deliver what other processes publish on the topic
+    LaneOptions lane;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lane = laneOptions_[static_cast<std::size_t>(priorityOf(signalId))];
+    }
+    IpcBridge::getInstance().listen(signalId, size, lane, historyOf(signalId));
+    updateInterest(signalId);
+}
+
+std::uint64_t SignalBus::replaceSubscribers(SignalId signalId, std::unique_ptr<SubscriberList> next)
+{
+    const std::uint64_t generation = ++generations_;
+    next->generation = generation;
+
+    // Seq_cst, ordered before the epoch flip that starts the old list's grace period
+    // and before what addSubscriber() reads from the topic's history
+    subscribers_[signalId].store(next.get(), std::memory_order_seq_cst);
+    if (snapshots_[signalId] != nullptr)
+    {
+        retiring_.push_back(std::move(snapshots_[signalId]));
+    }
+    snapshots_[signalId] = std::move(next);
+    reclaimSnapshots();
+    return generation;
+}
+
+void SignalBus::reclaimSnapshots()
+{
+    for (;;)
+    {
+        if (!draining_.empty())
+        {
+            // Publishers of the previous epoch only leave, once none is left nobody holds these lists
+            const std::uint32_t previous = readerEpoch_.load(std::memory_order_relaxed) ^ 1U;
+            for (const ReaderStripe &stripe : readerStripes_)
+            {
+                if (stripe.readers[previous].load(std::memory_order_seq_cst) != 0)
+                {
+                    return;
+                }
+            }
+            draining_.clear();
+        }
+        if (retiring_.empty())
+        {
+            return;
+        }
+
+        // Seq_cst pairs with SnapshotPin: a publisher counted in the new epoch loads the current lists
+        draining_ = std::move(retiring_);
+        retiring_.clear();
+        readerEpoch_.store(readerEpoch_.load(std::memory_order_relaxed) ^ 1U, std::memory_order_seq_cst);
+    }
+}
+
+SignalBus::SnapshotPin::SnapshotPin(SignalBus &bus)
+    : readers_(bus.readerStripes_[threadStripe() % kReaderStripes]
+                   .readers[bus.readerEpoch_.load(std::memory_order_seq_cst)])
+{
+    readers_.fetch_add(1, std::memory_order_seq_cst);
+}
+
+SignalBus::SnapshotPin::~SnapshotPin()
+{
+    readers_.fetch_sub(1, std::memory_order_release);
+}
+
+void SignalBus::updateInterest(SignalId signalId)
+{
+    // Under the lock, so concurrent changes reach the transport in order
+    std::lock_guard<std::mutex> lock(mutex_);
+    IpcBridge::getInstance().setInterest(signalId, interestOf(subscribers_[signalId].load(std::memory_order_relaxed)));
+}
+
+std::size_t SignalBus::keepAccepted(const SubscriptionFilter &filter, std::vector<std::max_align_t> &payloads,
+                                    std::size_t count, std::size_t size)
+{
+    auto *bytes = reinterpret_cast<unsigned char *>(payloads.data());
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (filter.accepts(bytes + i * size))
+        {
+            std::memmove(bytes + kept * size, bytes + i * size, size);
+            ++kept;
+        }
+    }
+    return kept;
+}
+
+SignalInterest SignalBus::interestOf(const SubscriberList *subscribers)
+{
+    SignalInterest interest;
+    interest.all = false;
+    for (const Subscriber &subscriber : (subscribers != nullptr) ? *subscribers : SubscriberList{})
+    {
+        // Deadbands and predicates cannot be judged elsewhere, their subscribers need every sample
+        if (subscriber.filter.kind() != SubscriptionFilter::Kind::Range || interest.count == kMaxInterestRanges)
+        {
+            interest.all = true;
+            break;
+        }
+        interest.ranges[interest.count++] = subscriber.filter.range();
+    }
+    return interest;
+}
+
+void SignalBus::dispatchInternal(SignalId signalId, const void *payload)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+    metrics_.countPublished(signalId, 1);
+    fanOut(signalId, payload);
+}
+
+const SignalBus::SubscriberList *SignalBus::loadSubscribers(SignalId signalId, const void *payloads,
+                                                            std::size_t count)
+{
+    // No lock: a concurrent subscribe only affects later publishes. The caller holds a SnapshotPin.
+    SignalHistory *history = histories_[signalId].load(std::memory_order_acquire);
+    if (history == nullptr)
+    {
+        return subscribers_[signalId].load(std::memory_order_seq_cst);
+    }
+
+    // Loaded between recording and marking the samples, so addSubscriber() knows which ones we deliver
+    const std::uint64_t first = history->begin(payloads, count);
+    const SubscriberList *subscribers = subscribers_[signalId].load(std::memory_order_seq_cst);
+    history->finish(first, count, (subscribers != nullptr) ? subscribers->generation : 0);
+    return subscribers;
+}
+
+void SignalBus::fanOut(SignalId signalId, const void *payload)
+{
+    SnapshotPin pin(*this);
+    const SubscriberList *subscribers = loadSubscribers(signalId, payload, 1);
+    if (subscribers == nullptr)
+    {
+        return;
+    }
+    for (const Subscriber &subscriber : *subscribers)
+    {
+        if (subscriber.filter.accepts(payload))
+        {
+            deliver(subscriber, payload);
+        }
+    }
+}
 
-void SignalBus::dispatchInternal(const std::string &signalName, const ISignal &signalData)
+void SignalBus::dispatchBatch(SignalId signalId, const void *payloads, std::size_t size, std::size_t count)
 {
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+    metrics_.countPublished(signalId, count);
+
+    SnapshotPin pin(*this);
+    const SubscriberList *subscribers = loadSubscribers(signalId, payloads, count);
+    if (subscribers == nullptr)
+    {
+        return;
+    }
+    const auto *first = static_cast<const unsigned char *>(payloads);
+    if (isConflated(signalId))
+    {
+        // Intermediate states are superseded before anyone could act on them
+        first += (count - 1) * size;
+        count = 1;
+    }
+
+    for (const Subscriber &subscriber : *subscribers)
+    {
+        // A filtered queue takes what passes one by one, rejected samples are never copied in
+        if (subscriber.invokeBatch != nullptr && subscriber.filter.kind() == SubscriptionFilter::Kind::All)
+        {
+            subscriber.invokeBatch(subscriber, first, count);
+            continue;
+        }
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            if (subscriber.filter.accepts(first + i * size))
+            {
+                deliver(subscriber, first + i * size);
+            }
+        }
+    }
+}
+
+void SignalBus::publishBatch(const SignalBatch &batch)
+{
+    for (const SignalBatch::Run &run : batch.runs_)
+    {
+        // Only runs of the topic's bound type are published, like publish() through a channel
+        if (run.signalId >= kMaxSignals || payloadSizes_[run.signalId].load(std::memory_order_acquire) != run.size)
+        {
+            continue;
+        }
+        IpcBridge::getInstance().sendBatch(run.signalId, batch.payloads(run), run.size, run.count);
+        dispatchBatch(run.signalId, batch.payloads(run), run.size, run.count);
+    }
+}
+
+void SignalBus::dispatchExternal(SignalId signalId, const void *payload, std::size_t size)
+{
+    if (signalId >= kMaxSignals)
+    {
+        return;
+    }
+
+    // Unbound topics have no local subscribers; a bound one only accepts payloads of its type's size
+    std::size_t expected = payloadSizes_[signalId].load(std::memory_order_acquire);
+    if (expected == 0)
+    {
+        return;
+    }
+    if (expected != size)
+    {
+        std::cerr << "SignalBus Error: Type mismatch for signal " << nameOf(signalId) << std::endl;
+        return;
+    }
+    metrics_.countReceived(signalId);
+    fanOut(signalId, payload);
+}
+
+int SignalBus::pollFd() const
+{
+    return pollFd_;
+}
+
+void SignalBus::drainPolled(std::size_t maxPerQueue)
+{
+    std::uint64_t wakeups;
+    [[maybe_unused]] ssize_t got = read(pollFd_, &wakeups, sizeof(wakeups));
+
+    // Handlers may subscribe, so not under the lock; queues are never destroyed before the bus
+    std::vector<DeliveryQueue *> queues;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues = polled_;
+    }
+    bool more = false;
+    for (DeliveryQueue *queue : queues)
+    {
+        more = queue->drain(maxPerQueue) || more;
+    }
+    if (more)
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(pollFd_, &one, sizeof(one));
+    }
+}
+
+SignalBusMetrics SignalBus::metrics()
+{
+    SignalBusMetrics result = metrics_.collect(numSignals_.load(std::memory_order_acquire));
+    for (TopicMetrics &topic : result.topics)
+    {
+        topic.name = nameOf(topic.signalId);
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
-    if (subscribers_.count(signalName))
+    for (const auto &subscription : asyncSubscriptions_)
     {
-        // std::cout << "SignalBus: Dispatching internal signal '" << signalName << "'" << std::endl;
-        for (const auto &handler : subscribers_[signalName])
+        const std::uint16_t id = subscription->target.metricsId;
+        if (id < result.subscribers.size())
         {
-            handler(signalData);
+            const std::uint64_t dropped = subscription->queue->dropped();
+            result.subscribers[id].dropped += dropped;
+            result.topics[subscription->signalId].dropped += dropped;
         }
     }
-}
\ No newline at end of file
+    return result;
+}
@@ -16,33 +16,173 @@
 #ifndef COMMON_FRAMEWORK_SIGNAL_BUS_HPP
 #define COMMON_FRAMEWORK_SIGNAL_BUS_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
 #include <functional>
-#include <map>
+#include <span>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <iostream>
+#include <thread>
+#include <type_traits>
 
-#include "ISignal.hpp"
+#include "SignalExecutor.hpp"
+#include "SignalHistory.hpp"
+#include "SignalId.hpp"
+#include "SignalMetrics.hpp"
+#include "WireSchema.hpp"
 
-// Forward declare IpcBridge
+// FNV-1a over the topic name, usable in constant expressions
+constexpr std::uint64_t signalNameHash(std::string_view name)
+{
+    return fnv1a64(name);
+}
+
+// Topic name as a template argument: signalId<"SpeedSignal">()
+template <std::size_t N>
+struct SignalName
+{
+    char value[N]{};
+
+    constexpr SignalName(const char (&name)[N]) { std::copy_n(name, N, value); }
+    constexpr std::string_view view() const { return {value, N - 1}; }
+};
+
+// Address unique per payload type, identifies a topic's type without RTTI
+template <typename T>
+struct SignalTypeTag
+{
+    static constexpr char tag = 0;
+};
+
+template <typename T>
+constexpr const void *signalTypeKey()
+{
+    return &SignalTypeTag<T>::tag;
+}
+
+// Typed handle of a topic whose payload type was checked once, when the channel was created
+template <typename T>
+struct Channel
+{
+    SignalId id = kInvalidSignalId;
+
+    bool valid() const { return id != kInvalidSignalId; }
+};
 
-/*---CONCEPTUAL IPC LAYER (Will replace by real IPC)---*/
+/*---Updates of several topics published together, see SignalBus::publishBatch()---*/
+class SignalBatch
+{
+public:
+    // Appends an update; consecutive updates of one topic form a run and are handed over together
+    template <typename T>
+    void add(Channel<T> channel, const T &signalData)
+    {
+        append(channel.id, &signalData, sizeof(T));
+    }
+
+    // Empties the batch but keeps its memory, so a batch reused every cycle stops allocating
+    void clear();
+
+    bool empty() const { return runs_.empty(); }
+
+private:
+    friend class SignalBus;
+
+    struct Run
+    {
+        SignalId signalId;
+        std::size_t size;   // of one payload
+        std::size_t count;  // payloads, back to back from offset
+        std::size_t offset; // into storage_, max_align_t aligned
+    };
+
+    void append(SignalId signalId, const void *payload, std::size_t size);
+    const void *payloads(const Run &run) const
+    {
+        return reinterpret_cast<const unsigned char *>(storage_.data()) + run.offset;
+    }
+
+    std::vector<Run> runs_;
+    std::vector<std::max_align_t> storage_; // payload bytes; max_align_t so handlers read them in place
+    std::size_t used_ = 0;                  // bytes of storage_ in use
+};
+
+/*---How the IPC layer carries a topic's messages to other processes---*/
+class IpcTransport
+{
+public:
+    using Receiver = std::function<void(SignalId signalId, const void *payload, std::size_t size)>;
+
+    virtual ~IpcTransport() = default;
+
+    // Hands count payloads of size bytes, laid out back to back, to the topic's peers
+    virtual void send(SignalId signalId, const void *payloads, std::size_t size, std::size_t count) = 0;
+
+    // Starts passing the topic's messages from other processes to receiver, where the transport
+    // has threads of its own with the priority and affinity of the topic's lane. Up to history
+    // messages peers sent before are passed first, as far as the transport still holds them.
+    virtual void listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history,
+                        const Receiver &receiver) = 0;
+
+    // What this process still wants of a topic it listens to. A transport that can tell the topic's
+    // publishers lets them skip what no process wants; the default only filters on arrival.
+    virtual void setInterest(SignalId /*signalId*/, const SignalInterest & /*interest*/) {}
+
+    // Stops listening, receivers are not called afterwards
+    virtual void shutdown() = 0;
+};
+
+/*---IPC LAYER: shared memory rings by default (see ShmTransport.hpp), or another transport---*/
 class IpcBridge
 {
 public:
     // A simplified callback type for when a signal is received from IPC
-    using IpcSignalReceiver = std::function<void(const std::string &signalName, const ISignal &signalData)>;
+    using IpcSignalReceiver = std::function<void(SignalId signalId, const void *payload, std::size_t size)>;
 
     static IpcBridge &getInstance(); // Singleton access
 
     void registerIpcReceiver(IpcSignalReceiver receiver);
-    void sendSignal(const std::string &signalName, const ISignal &signalData);
 
-    // This simulates receiving a signal from IPC and dispatching it to the registered receiver.
-    // This method would be called by IPC's event loop when a message arrives.
-    void receiveAndDispatch(const std::string &signalName, const ISignal &signalData);
+    // Replaces the transport, e.g. with a DdsTransport to reach other nodes. Call it before the
+    // first publish or subscribe: topics already listened to stay with the previous transport.
+    void setTransport(std::unique_ptr<IpcTransport> transport);
+
+    // Hands the payload to the transport
+    void sendSignal(SignalId signalId, const void *payload, std::size_t size);
+
+    // Same for count payloads laid out back to back
+    void sendBatch(SignalId signalId, const void *payloads, std::size_t size, std::size_t count);
+
+    // Starts delivering the topic's messages from other processes to the receiver,
+    // with the priority and affinity of the topic's lane, up to history earlier ones first
+    void listen(SignalId signalId, std::size_t size, const LaneOptions &lane, std::size_t history = 0);
+
+    // Passes the topic's subscriber filters on to the transport
+    void setInterest(SignalId signalId, const SignalInterest &interest);
+
+    // Stops the transports' listeners, the receiver is not called afterwards
+    void shutdown();
+
+    // Dispatches a signal to the registered receiver as if it had arrived by IPC.
+    // Used to inject signals in-process, e.g. for simulation.
+    void receiveAndDispatch(SignalId signalId, const void *payload, std::size_t size);
+    void receiveAndDispatch(const std::string &signalName, const void *payload, std::size_t size); // Interns the wire name
+
+    template <typename T>
+    void receiveAndDispatch(Channel<T> channel, const T &signalData)
+    {
+        receiveAndDispatch(channel.id, &signalData, sizeof(T));
+    }
 
 private:
     IpcBridge(); // Private constructor for Singleton
@@ -51,8 +191,13 @@ private:
     IpcBridge &operator=(const IpcBridge &) = delete;
 
     IpcSignalReceiver ipcReceiver_;
+
+    // Senders read the active transport without a lock; replaced ones are kept until the bridge goes away
+    std::atomic<IpcTransport *> transport_{nullptr};
+    std::vector<std::unique_ptr<IpcTransport>> transports_;
+    std::mutex mutex_;
 };
-/*--- END CONCEPTUAL IPC LAYER ---*/
+/*--- END IPC LAYER ---*/
 
 /*--- The application's in-process SignalBus, which uses the IPC Bridge ---*/
 class SignalBus
@@ -60,49 +205,280 @@ class SignalBus
 public:
     static SignalBus &getInstance(); // Singleton access
 
-    // Subscribe to a signal type within this process
+    // Topic registry: maps a name to its dense ID once, at setup time
+    SignalId intern(std::string_view signalName);
+    SignalId intern(std::string_view signalName, std::uint64_t nameHash);
+    const std::string &nameOf(SignalId signalId) const;
+
+    // Fingerprint of the wire struct bound to the topic, 0 while unbound
+    std::uint64_t wireFingerprintOf(SignalId signalId);
+
+    // Binds the topic to payload type T on first use; an invalid channel if it is bound to another type
+    template <typename T>
+    Channel<T> channel(SignalId signalId)
+    {
+        static_assert(WireStruct<T>, "signal payloads cross processes as is, declare them with SIGNAL_WIRE_STRUCT");
+        return Channel<T>{bindType(signalId, signalTypeKey<T>(), sizeof(T), wireFingerprint<T>()) ? signalId
+                                                                                                 : kInvalidSignalId};
+    }
+
+    // Subscribe to a signal type within this process. Inline handlers are called directly on
+    // the publisher's thread; options select a queued delivery mode instead (see SignalExecutor.hpp)
+    // and may filter the samples before they are queued or handled (see SignalFilter.hpp).
+    template <auto Method, typename T, typename Class>
+    void subscribe(Channel<T> channel, Class *instance, const SubscribeOptions &options = {})
+    {
+        Subscriber subscriber{};
+        subscriber.invoke = [](const Subscriber &self, const void *payload)
+        {
+            (static_cast<Class *>(self.instance)->*Method)(*static_cast<const T *>(payload));
+        };
+        subscriber.instance = instance;
+        addSubscriber(channel.id, subscriber, options);
+    }
+
+    template <typename T, typename Class>
+    void subscribe(Channel<T> channel, Class *instance, void (Class::*method)(const T &),
+                   const SubscribeOptions &options = {})
+    {
+        using Method = void (Class::*)(const T &);
+        static_assert(sizeof(Method) <= sizeof(Subscriber::method), "member function pointer too large");
+
+        Subscriber subscriber{};
+        subscriber.invoke = [](const Subscriber &self, const void *payload)
+        {
+            Method bound;
+            std::memcpy(&bound, self.method, sizeof(bound));
+            (static_cast<Class *>(self.instance)->*bound)(*static_cast<const T *>(payload));
+        };
+        subscriber.instance = instance;
+        std::memcpy(subscriber.method, &method, sizeof(method));
+        addSubscriber(channel.id, subscriber, options);
+    }
+
+    // The payload type is taken from the handler and checked against the topic here, once
+    template <typename T, typename Class>
+    void subscribe(SignalId signalId, Class *instance, void (Class::*method)(const T &))
+    {
+        subscribe(channel<T>(signalId), instance, method);
+    }
+
     template <typename T, typename Class>
     void subscribe(const std::string &signalName, Class *instance, void (Class::*method)(const T &))
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        subscribers_[signalName].push_back(
-            [instance, method, signalName](const ISignal &signal)
-            {
-                // Dynamic cast to the concrete signal type (safe due to ISignal inheritance)
-                if (const T *concreteSignal = dynamic_cast<const T *>(&signal))
-                {
-                    (instance->*method)(*concreteSignal);
-                }
-                else
-                {
-                    std::cerr << "SignalBus Error: Type mismatch for signal " << signalName << std::endl;
-                }
-            });
-        std::cout << "SignalBus: Subscribed to '" << signalName << "'" << std::endl;
+        subscribe(channel<T>(intern(signalName)), instance, method);
     }
 
-    // Publish a signal (internally and via IPC)
+    // Removes every subscription of instance. Queued deliveries are discarded and one in progress is
+    // waited for; inline handlers may still run on publishers that began dispatching before the call.
+    void unsubscribe(const void *instance);
+
+    // Threads serving DeliveryMode::Pool subscribers; takes effect if called before the first such subscription
+    void setWorkerPoolSize(std::size_t threads);
+
+    // DeliveryMode::Polled subscribers run on the thread calling drainPolled(), typically an event
+    // loop waiting for pollFd(), an eventfd, to become readable. Each call delivers up to
+    // maxPerQueue samples per subscriber and makes the fd readable again if more are left.
+    int pollFd() const;
+    void drainPolled(std::size_t maxPerQueue = 64);
+
+    // Priority class of a topic (default Normal). Set it before subscribing: the lane's thread
+    // options apply to threads started for the topic's subscriptions from then on.
+    void setPriority(SignalId signalId, SignalPriority priority);
+    SignalPriority priorityOf(SignalId signalId) const;
+
+    // Threads of a lane; takes effect if called before the first pool subscription
+    void configureLane(SignalPriority lane, const LaneOptions &options);
+
+    // A conflated topic carries state rather than events: subscribers only need its latest value.
+    // Queued subscriptions made afterwards hold one sample that newer ones overwrite, batches
+    // deliver their last update only and IPC readers skip straight to the newest message.
+    // Set it before subscribing, like the priority.
+    void setConflated(SignalId signalId, bool conflated);
+    bool isConflated(SignalId signalId) const;
+
+    // Keeps the topic's last depth samples (at most kMaxHistoryDepth), published here or received by
+    // IPC, in a ring publishers write without a lock. A new subscriber gets them oldest first, ahead of
+    // live samples and without repeating one it gets live; a queued one as many as its queue holds.
+    // The topic's first subscription also asks the IPC transport for what peers published before,
+    // so a restarted process starts from current values.
+    // Set it once, before publishing or subscribing.
     template <typename T>
-    void publish(const std::string &signalName, const T &signalData)
+    void setHistory(Channel<T> channel, std::size_t depth)
+    {
+        setHistory(channel.id, sizeof(T), depth);
+    }
+    std::size_t historyOf(SignalId signalId) const; // 0 without history
+
+    // Counters since start, summed over every thread on each call, e.g. metrics().print(std::cout).
+    // Counting is always on: a few relaxed stores and two clock reads per handler call.
+    SignalBusMetrics metrics();
+
+    // Publish a signal (internally and via IPC). No string hashing, comparison, allocation or RTTI.
+    // Queued subscribers cost a copy into their queue, whatever their handlers do.
+    template <typename T>
+    void publish(Channel<T> channel, const T &signalData)
     {
         // Send via IPC for other processes
-        IpcBridge::getInstance().sendSignal(signalName, signalData);
+        IpcBridge::getInstance().sendSignal(channel.id, &signalData, sizeof(T));
 
         // Also dispatch internally for subscribers within this process
-        dispatchInternal(signalName, signalData);
+        dispatchInternal(channel.id, &signalData);
+    }
+
+    // Publishes many updates of one topic: one IPC write and wakeup, one subscriber list load and
+    // one queue lock per queued subscriber for the whole batch. Inline handlers still see every update.
+    template <typename T>
+    void publishBatch(Channel<T> channel, std::span<const T> signals)
+    {
+        if (signals.empty())
+        {
+            return;
+        }
+        IpcBridge::getInstance().sendBatch(channel.id, signals.data(), sizeof(T), signals.size());
+        dispatchBatch(channel.id, signals.data(), sizeof(T), signals.size());
     }
 
+    // Publishes the updates of several topics, run by run in the order they were added
+    void publishBatch(const SignalBatch &batch);
+
 private:
     SignalBus(); // Private constructor for Singleton
     ~SignalBus();
     SignalBus(const SignalBus &) = delete;
     SignalBus &operator=(const SignalBus &) = delete;
 
-    // Internal dispatching logic
-    void dispatchInternal(const std::string &signalName, const ISignal &signalData);
+    // Type-erased without a heap closure: a thunk, the object and the member function pointer
+    struct Subscriber
+    {
+        void (*invoke)(const Subscriber &self, const void *payload);
+        // Set on queued subscribers: takes count payloads at once, back to back
+        void (*invokeBatch)(const Subscriber &self, const void *payloads, std::size_t count);
+        void *instance;
+        alignas(void *) unsigned char method[2 * sizeof(void *)];
+        std::uint16_t metricsId = kNoMetrics; // set on the subscriber whose handler is timed
+        SubscriptionFilter filter;            // on the list entry, so rejected samples are not queued
+    };
+    // Immutable once published; the generation tells a topic's successive lists apart
+    struct SubscriberList : std::vector<Subscriber>
+    {
+        std::uint64_t generation = 0;
+    };
+
+    // Internal dispatching logic, payload must be of the topic's bound type
+    void dispatchInternal(SignalId signalId, const void *payload);
+    void fanOut(SignalId signalId, const void *payload);
+    const SubscriberList *loadSubscribers(SignalId signalId, const void *payloads, std::size_t count);
+    void dispatchBatch(SignalId signalId, const void *payloads, std::size_t size, std::size_t count);
+
+    // Payload arriving by IPC, checked against the size of the topic's bound type
+    void dispatchExternal(SignalId signalId, const void *payload, std::size_t size);
+
+    bool bindType(SignalId signalId, const void *typeKey, std::size_t size, std::uint64_t fingerprint);
+    void setHistory(SignalId signalId, std::size_t size, std::size_t depth);
+
+    // Union of the range filters of the topic's subscribers, declared to other processes' publishers
+    static SignalInterest interestOf(const SubscriberList *subscribers);
+    void updateInterest(SignalId signalId);
+
+    // Moves the first count payloads the filter accepts to the front, returns how many
+    static std::size_t keepAccepted(const SubscriptionFilter &filter, std::vector<std::max_align_t> &payloads,
+                                    std::size_t count, std::size_t size);
+
+    // Copies the topic's list, appends subscriber and publishes the copy
+    void addSubscriber(SignalId signalId, const Subscriber &subscriber, const SubscribeOptions &options);
+
+    // Queued subscriber: the list entry posts to the queue, which calls the real handler later
+    struct AsyncSubscription
+    {
+        SignalId signalId;
+        Subscriber target;
+        std::unique_ptr<DeliveryQueue> queue;
+    };
+    static void deliverQueued(const void *context, const void *payload, std::int64_t queuedAtNs);
+
+    // Calls the handler, timed if the subscriber is counted; queuedAtNs < 0 for inline delivery
+    void deliver(const Subscriber &subscriber, const void *payload, std::int64_t queuedAtNs = -1);
+    Subscriber makeQueued(SignalId signalId, const Subscriber &target, const SubscribeOptions &options);
 
-    std::map<std::string, std::vector<std::function<void(const ISignal &)>>> subscribers_;
-    std::mutex mutex_; // For thread-safe access to subscribers_
+    // Installs next as the topic's snapshot and retires the one it replaces; called with mutex_ held.
+    // Returns the generation given to next.
+    std::uint64_t replaceSubscribers(SignalId signalId, std::unique_ptr<SubscriberList> next);
+    // Frees retired snapshots no publisher can still be iterating; called with mutex_ held
+    void reclaimSnapshots();
+
+    // Counts a publisher in, in the current reader epoch, from loading a snapshot until it is done iterating it
+    class SnapshotPin
+    {
+    public:
+        explicit SnapshotPin(SignalBus &bus);
+        ~SnapshotPin();
+
+        SnapshotPin(const SnapshotPin &) = delete;
+        SnapshotPin &operator=(const SnapshotPin &) = delete;
+
+    private:
+        std::atomic<std::uint32_t> &readers_;
+    };
+
+    // Publishers in flight per reader epoch, spread over stripes by thread so they do not share a cache line
+    struct alignas(64) ReaderStripe
+    {
+        std::array<std::atomic<std::uint32_t>, 2> readers{};
+    };
+    static constexpr std::size_t kReaderStripes = 16;
+
+    // Flat subscriber table indexed by SignalId. Each entry points to an immutable
+    // snapshot, so publishers read without a lock and may publish from a handler.
+    std::array<std::atomic<const SubscriberList *>, kMaxSignals> subscribers_{};
+    std::array<std::unique_ptr<const SubscriberList>, kMaxSignals> snapshots_; // owns each topic's current snapshot
+    // Replaced snapshots wait out a grace period: retiring_ ones until the reader epoch flips, draining_
+    // ones until the publishers counted in the previous epoch are gone. Only the next subscription
+    // change frees them, so at most the lists replaced since then are held.
+    std::vector<std::unique_ptr<const SubscriberList>> retiring_;
+    std::vector<std::unique_ptr<const SubscriberList>> draining_;
+    std::uint64_t generations_ = 0; // given out to lists so far
+    std::atomic<std::uint32_t> readerEpoch_{0}; // 0 or 1
+    std::array<ReaderStripe, kReaderStripes> readerStripes_{};
+    std::mutex mutex_; // Serializes writers (subscribe, unsubscribe) only
+
+    std::vector<std::unique_ptr<AsyncSubscription>> asyncSubscriptions_;
+    std::unique_ptr<WorkerPool> workerPool_; // created with the first pool subscription
+    std::vector<DeliveryQueue *> polled_;    // queues of Polled subscribers, owned by asyncSubscriptions_
+    int pollFd_ = -1;
+    std::size_t workerPoolSize_ = 2;
+    std::array<LaneOptions, kSignalPriorities> laneOptions_{};
+    std::array<std::atomic<SignalPriority>, kMaxSignals> priorities_{};
+    std::array<std::atomic<bool>, kMaxSignals> conflated_{};
+    std::array<std::atomic<SignalHistory *>, kMaxSignals> histories_{}; // nullptr: no history kept
+    std::vector<std::unique_ptr<SignalHistory>> ownedHistories_;
+    std::deque<std::atomic<double>> deadbands_; // state of deadband filters, stable addresses
+    SignalMetrics metrics_;
+
+    // Registry: names_[id] is written once before numSignals_ is published
+    std::array<std::string, kMaxSignals> names_;
+    std::array<const void *, kMaxSignals> types_{};     // Payload type bound to each topic
+    std::array<std::atomic<std::size_t>, kMaxSignals> payloadSizes_{}; // 0 until bound, read by dispatchExternal
+    std::array<std::uint64_t, kMaxSignals> fingerprints_{};            // Wire schema of each bound topic
+    std::atomic<std::size_t> numSignals_{0};
+    std::unordered_map<std::uint64_t, SignalId> idsByHash_;
+    std::mutex registryMutex_;
 };
 
+// Interned once per name, later calls are a static load; the name is hashed at compile time
+template <SignalName Name>
+SignalId signalId()
+{
+    static const SignalId id = SignalBus::getInstance().intern(Name.view(), signalNameHash(Name.view()));
+    return id;
+}
+
+// Typed channel for a topic name, type checked once: signalChannel<SpeedSignal, "SpeedSignal">()
+template <typename T, SignalName Name>
+Channel<T> signalChannel()
+{
+    static const Channel<T> channel = SignalBus::getInstance().channel<T>(signalId<Name>());
+    return channel;
+}
+
 #endif // COMMON_FRAMEWORK_SIGNAL_BUS_HPP
\ No newline at end of file
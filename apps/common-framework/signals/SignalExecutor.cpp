@@ -0,0 +1,424 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SignalExecutor.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace
+{
+constexpr std::size_t kPoolBatch = 16; // payloads a worker delivers before it looks for higher lanes again
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void nameThread(std::thread &thread, const std::string &name)
+{
+    // The kernel keeps 15 characters
+    pthread_setname_np(thread.native_handle(), name.substr(0, 15).c_str());
+}
+} // namespace
+
+void configureThread(std::thread &thread, const std::string &name, const LaneOptions &options)
+{
+    nameThread(thread, name);
+
+    if (options.realtimePriority > 0)
+    {
+        sched_param param{};
+        param.sched_priority = options.realtimePriority;
+        int err = pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+        if (err != 0)
+        {
+            std::cerr << "SignalBus Warning: Could not give '" << name << "' realtime priority "
+                      << options.realtimePriority << ": " << std::strerror(err) << std::endl;
+        }
+    }
+    if (options.cpu >= 0)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(options.cpu, &cpus);
+        int err = pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+        if (err != 0)
+        {
+            std::cerr << "SignalBus Warning: Could not pin '" << name << "' to CPU " << options.cpu << ": "
+                      << std::strerror(err) << std::endl;
+        }
+    }
+}
+
+DeliveryQueue::DeliveryQueue(Deliver deliver, const void *context, std::size_t payloadSize,
+                             const SubscribeOptions &options, WorkerPool *pool, SignalPriority lane)
+    : deliver_(deliver),
+      context_(context),
+      payloadSize_(payloadSize),
+      stride_((payloadSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)),
+      capacity_(std::max<std::size_t>(options.queueCapacity, 1)),
+      overflow_(options.overflow),
+      pool_(pool),
+      lane_(lane),
+      storage_(new std::max_align_t[stride_ * (capacity_ + 1)]),
+      postedAt_(new std::int64_t[capacity_])
+{
+}
+
+DeliveryQueue::~DeliveryQueue()
+{
+    stop();
+}
+
+void *DeliveryQueue::slot(std::size_t index)
+{
+    return storage_.get() + index * stride_;
+}
+
+void DeliveryQueue::post(const void *payload)
+{
+    postBatch(payload, 1);
+}
+
+void DeliveryQueue::postBatch(const void *payloads, std::size_t count)
+{
+    const auto *payload = static_cast<const unsigned char *>(payloads);
+    const std::int64_t postedAt = nowNs();
+    bool schedule = false;
+    bool notify = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (std::size_t i = 0; i < count && !stopped_; ++i, payload += payloadSize_)
+        {
+            if (count_ == capacity_)
+            {
+                switch (overflow_)
+                {
+                case OverflowPolicy::DropOldest:
+                    head_ = (head_ + 1) % capacity_;
+                    --count_;
+                    ++dropped_;
+                    break;
+                case OverflowPolicy::Coalesce:
+                    std::memcpy(slot((head_ + count_ - 1) % capacity_), payload, payloadSize_);
+                    postedAt_[(head_ + count_ - 1) % capacity_] = postedAt;
+                    ++dropped_;
+                    continue;
+                case OverflowPolicy::Block:
+                    // Whatever drains the queue has to be woken before we wait for it to make room
+                    lock.unlock();
+                    wake(schedule, notify);
+                    schedule = false;
+                    notify = false;
+                    lock.lock();
+                    notFull_.wait(lock, [this] { return count_ < capacity_ || stopped_; });
+                    if (stopped_)
+                    {
+                        return;
+                    }
+                    break;
+                }
+            }
+
+            std::memcpy(slot((head_ + count_) % capacity_), payload, payloadSize_);
+            postedAt_[(head_ + count_) % capacity_] = postedAt;
+            ++count_;
+            if (held_)
+            {
+                continue;
+            }
+            if (pool_ != nullptr && !scheduled_)
+            {
+                scheduled_ = true;
+                schedule = true;
+            }
+            else if (notifyFd_ >= 0 && !scheduled_)
+            {
+                scheduled_ = true;
+                notify = true;
+            }
+        }
+    }
+
+    wake(schedule, notify);
+}
+
+// Called without mutex_ held
+void DeliveryQueue::wake(bool schedule, bool notify)
+{
+    if (schedule)
+    {
+        pool_->schedule(this);
+    }
+    else if (notify)
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(notifyFd_, &one, sizeof(one));
+    }
+    else if (pool_ == nullptr)
+    {
+        notEmpty_.notify_one();
+    }
+}
+
+bool DeliveryQueue::drain(std::size_t maxItems)
+{
+    // Only one thread drains a queue at a time, so the scratch slot is ours
+    void *scratch = slot(capacity_);
+
+    for (std::size_t delivered = 0; delivered < maxItems; ++delivered)
+    {
+        std::int64_t postedAt;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (count_ == 0 || stopped_ || held_)
+            {
+                scheduled_ = false;
+                return false;
+            }
+            std::memcpy(scratch, slot(head_), payloadSize_);
+            postedAt = postedAt_[head_];
+            head_ = (head_ + 1) % capacity_;
+            --count_;
+            delivering_ = true;
+            drainer_ = std::this_thread::get_id();
+        }
+        notFull_.notify_one();
+
+        // The handler runs without the lock, publishers keep queueing meanwhile
+        deliver_(context_, scratch, postedAt);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            delivering_ = false;
+        }
+        idle_.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0 || stopped_ || held_)
+    {
+        scheduled_ = false;
+        return false;
+    }
+    return true;
+}
+
+SignalPriority DeliveryQueue::lane() const
+{
+    return lane_.load(std::memory_order_relaxed);
+}
+
+void DeliveryQueue::setLane(SignalPriority lane)
+{
+    // Takes effect the next time the queue is scheduled
+    lane_.store(lane, std::memory_order_relaxed);
+}
+
+void DeliveryQueue::startDedicated(const std::string &name, const LaneOptions &options)
+{
+    thread_ = std::thread(
+        [this]
+        {
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    notEmpty_.wait(lock, [this] { return (count_ > 0 && !held_) || stopped_; });
+                    if (stopped_)
+                    {
+                        return;
+                    }
+                }
+                drain(capacity_);
+            }
+        });
+    configureThread(thread_, name, options);
+}
+
+void DeliveryQueue::notifyThrough(int eventFd)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    notifyFd_ = eventFd;
+}
+
+void DeliveryQueue::hold()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_ = true;
+}
+
+void DeliveryQueue::release(const void *payloads, std::size_t count)
+{
+    bool schedule = false;
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const std::size_t kept = std::min(count, capacity_ - count_);
+        const auto *payload = static_cast<const unsigned char *>(payloads) + (count - kept) * payloadSize_;
+        const std::int64_t postedAt = nowNs();
+
+        // Written backwards in front of the head, so the oldest ends up first
+        payload += kept * payloadSize_;
+        for (std::size_t i = 0; i < kept; ++i)
+        {
+            payload -= payloadSize_;
+            head_ = (head_ + capacity_ - 1) % capacity_;
+            std::memcpy(slot(head_), payload, payloadSize_);
+            postedAt_[head_] = postedAt;
+            ++count_;
+        }
+        held_ = false;
+        if (count_ > 0 && !scheduled_ && !stopped_)
+        {
+            scheduled_ = pool_ != nullptr || notifyFd_ >= 0;
+            schedule = pool_ != nullptr;
+            notify = pool_ == nullptr && notifyFd_ >= 0;
+        }
+    }
+    wake(schedule, notify);
+}
+
+void DeliveryQueue::stop()
+{
+    bool fromHandler;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        fromHandler = delivering_ && drainer_ == std::this_thread::get_id();
+        stopped_ = true;
+        count_ = 0;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+        if (!fromHandler)
+        {
+            idle_.wait(lock, [this] { return !delivering_; });
+        }
+    }
+    if (thread_.joinable() && !fromHandler)
+    {
+        thread_.join();
+    }
+}
+
+std::uint64_t DeliveryQueue::dropped() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+WorkerPool::WorkerPool(std::size_t sharedThreads, const std::array<LaneOptions, kSignalPriorities> &lanes)
+{
+    for (std::size_t lane = 0; lane < kSignalPriorities; ++lane)
+    {
+        ownThreads_[lane] = lanes[lane].threads > 0;
+        for (std::size_t i = 0; i < lanes[lane].threads; ++i)
+        {
+            threads_.emplace_back(&WorkerPool::run, this, static_cast<int>(lane));
+            configureThread(threads_.back(), "sigbus-lane" + std::to_string(lane) + "-" + std::to_string(i),
+                            lanes[lane]);
+        }
+    }
+
+    // Shared threads are only needed while some lane has none of its own
+    if (std::find(ownThreads_.begin(), ownThreads_.end(), false) != ownThreads_.end())
+    {
+        for (std::size_t i = 0; i < std::max<std::size_t>(sharedThreads, 1); ++i)
+        {
+            threads_.emplace_back(&WorkerPool::run, this, kSharedLane);
+            configureThread(threads_.back(), "sigbus-pool-" + std::to_string(i), LaneOptions{});
+        }
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    sharedCv_.notify_all();
+    for (std::condition_variable &cv : laneCv_)
+    {
+        cv.notify_all();
+    }
+    for (std::thread &thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::schedule(DeliveryQueue *queue)
+{
+    const std::size_t lane = static_cast<std::size_t>(queue->lane());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready_[lane].push_back(queue);
+    }
+    if (ownThreads_[lane])
+    {
+        laneCv_[lane].notify_one();
+    }
+    else
+    {
+        sharedCv_.notify_one();
+    }
+}
+
+// Called with mutex_ held; nullptr if the worker has nothing to do
+DeliveryQueue *WorkerPool::take(int lane)
+{
+    for (std::size_t candidate = 0; candidate < kSignalPriorities; ++candidate)
+    {
+        bool serves = (lane == kSharedLane) ? !ownThreads_[candidate] : static_cast<int>(candidate) == lane;
+        if (serves && !ready_[candidate].empty())
+        {
+            DeliveryQueue *queue = ready_[candidate].front();
+            ready_[candidate].pop_front();
+            return queue;
+        }
+    }
+    return nullptr;
+}
+
+void WorkerPool::run(int lane)
+{
+    std::condition_variable &cv = (lane == kSharedLane) ? sharedCv_ : laneCv_[static_cast<std::size_t>(lane)];
+
+    for (;;)
+    {
+        DeliveryQueue *queue = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv.wait(lock, [&] { return stopping_ || (queue = take(lane)) != nullptr; });
+            if (stopping_)
+            {
+                return;
+            }
+        }
+
+        // Round robin within a lane; a queue goes back to the end of its lane while it has work left
+        if (queue->drain(kPoolBatch))
+        {
+            schedule(queue);
+        }
+    }
+}
@@ -0,0 +1,190 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SIGNAL_EXECUTOR_HPP
+#define COMMON_FRAMEWORK_SIGNAL_EXECUTOR_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SignalFilter.hpp"
+
+// Priority class of a topic; every class is a separate lane, higher lanes are drained first
+enum class SignalPriority : std::uint8_t
+{
+    Critical, // e.g. brake requests
+    High,
+    Normal,
+    Low, // e.g. telemetry
+};
+inline constexpr std::size_t kSignalPriorities = 4;
+
+// Threads of a lane. Priority and affinity also apply to the lane's IPC reader and dedicated threads.
+struct LaneOptions
+{
+    std::size_t threads = 0;  // pool threads serving only this lane, 0: served by the shared pool threads
+    int realtimePriority = 0; // SCHED_FIFO priority, 0 keeps the normal scheduler
+    int cpu = -1;             // pins the lane's threads to one CPU, -1 leaves them free
+};
+
+// Names a thread and applies the lane's priority and affinity; failures are reported, not fatal
+void configureThread(std::thread &thread, const std::string &name, const LaneOptions &options);
+
+// Where a subscriber's handler runs
+enum class DeliveryMode
+{
+    Inline,    // on the publisher's thread, before publish() returns
+    Dedicated, // on a thread of its own, fed by the subscriber's queue
+    Pool,      // on the SignalBus worker pool, in publish order per subscriber
+    Polled,    // on the thread calling SignalBus::drainPolled(), woken through SignalBus::pollFd()
+};
+
+// What publish() does when a subscriber's queue is full
+enum class OverflowPolicy
+{
+    DropOldest, // discard the oldest queued sample
+    Coalesce,   // overwrite the newest queued sample, only the latest value matters
+    Block,      // wait for room; never use it from a handler the same worker serves, not for Polled subscribers
+};
+
+struct SubscribeOptions
+{
+    DeliveryMode mode = DeliveryMode::Inline;
+    std::size_t queueCapacity = 64;
+    OverflowPolicy overflow = OverflowPolicy::DropOldest;
+    std::chrono::nanoseconds budget{0}; // handler time above which the subscriber is reported as slow, 0: none
+    SubscriptionFilter filter{};        // samples it wants, checked before queueing (see SignalFilter.hpp)
+};
+
+class WorkerPool;
+
+/*---Bounded queue of payload copies in front of one asynchronous subscriber---*/
+class DeliveryQueue
+{
+public:
+    // queuedAtNs: steady clock time the payload was posted
+    using Deliver = void (*)(const void *context, const void *payload, std::int64_t queuedAtNs);
+
+    // pool == nullptr: drained by a thread started with startDedicated()
+    DeliveryQueue(Deliver deliver, const void *context, std::size_t payloadSize, const SubscribeOptions &options,
+                  WorkerPool *pool, SignalPriority lane);
+    ~DeliveryQueue();
+
+    DeliveryQueue(const DeliveryQueue &) = delete;
+    DeliveryQueue &operator=(const DeliveryQueue &) = delete;
+
+    // Publisher side: copies the payload in and applies the overflow policy
+    void post(const void *payload);
+
+    // Same for count payloads laid out back to back, under one lock and with one wakeup
+    void postBatch(const void *payloads, std::size_t count);
+
+    // Delivers up to maxItems payloads on the calling thread; true if more are queued
+    bool drain(std::size_t maxItems);
+
+    void startDedicated(const std::string &name, const LaneOptions &options);
+
+    // Drained by whoever watches the eventfd: it is written each time the queue stops being empty
+    void notifyThrough(int eventFd);
+
+    // Keeps the queue from being drained until release(); posts meanwhile only queue up
+    void hold();
+
+    // Queues count payloads ahead of those posted while held, as many of the newest as there is room
+    // for, and lets the queue be drained
+    void release(const void *payloads, std::size_t count);
+
+    SignalPriority lane() const;
+    void setLane(SignalPriority lane);
+
+    // Discards what is queued, releases blocked publishers and waits for a delivery in progress,
+    // unless called from that delivery's handler. The handler is not called afterwards.
+    void stop();
+
+    std::uint64_t dropped() const;
+
+private:
+    void *slot(std::size_t index);
+
+    // Hands the queue to the pool, writes the eventfd or wakes the dedicated thread
+    void wake(bool schedule, bool notify);
+
+    Deliver deliver_;
+    const void *context_;
+    std::size_t payloadSize_;
+    std::size_t stride_;
+    std::size_t capacity_;
+    OverflowPolicy overflow_;
+    WorkerPool *pool_;
+    int notifyFd_ = -1;
+    std::atomic<SignalPriority> lane_;
+
+    std::unique_ptr<std::max_align_t[]> storage_; // capacity_ slots, then one scratch slot for the drainer
+    std::unique_ptr<std::int64_t[]> postedAt_;    // per slot, for the queueing delay
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    bool scheduled_ = false; // handed to the pool and not yet drained empty
+    bool held_ = false;
+    bool stopped_ = false;
+    bool delivering_ = false;
+    std::thread::id drainer_;
+    std::uint64_t dropped_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+    std::condition_variable idle_;
+    std::thread thread_;
+};
+
+/*---Threads serving DeliveryMode::Pool subscribers, one ready list per priority lane---*/
+class WorkerPool
+{
+public:
+    // sharedThreads serve every lane without threads of its own, highest lane first
+    WorkerPool(std::size_t sharedThreads, const std::array<LaneOptions, kSignalPriorities> &lanes);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Queues the subscriber queue on its lane; each queue is scheduled at most once at a time
+    void schedule(DeliveryQueue *queue);
+
+private:
+    static constexpr int kSharedLane = -1;
+
+    void run(int lane);
+    DeliveryQueue *take(int lane);
+
+    std::array<std::deque<DeliveryQueue *>, kSignalPriorities> ready_;
+    std::array<bool, kSignalPriorities> ownThreads_{};
+    bool stopping_ = false;
+    std::mutex mutex_;
+    std::condition_variable sharedCv_;
+    std::array<std::condition_variable, kSignalPriorities> laneCv_;
+    std::vector<std::thread> threads_;
+};
+
+#endif // COMMON_FRAMEWORK_SIGNAL_EXECUTOR_HPP
@@ -0,0 +1,297 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SIGNAL_FILTER_HPP
+#define COMMON_FRAMEWORK_SIGNAL_FILTER_HPP
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "WireSchema.hpp"
+
+/*
+ * Content filters: a subscription names the samples it wants and the bus drops
+ * the others before it queues them or calls the handler.
+ *
+ *   auto fast = SignalFilter<SpeedSignal>::range<&SpeedSignal::speed_kmph>(120, 400);
+ *   auto moved = SignalFilter<BrakeRequestSignal>::deadband<&BrakeRequestSignal::brake_pedal_position>(0.05);
+ *   SubscribeOptions options;
+ *   options.filter = fast;
+ *
+ * Range filters are plain data: processes subscribing through shared memory
+ * declare them in the topic's ring, and publishers in other processes skip
+ * samples no reader wants instead of copying them. On a topic with history
+ * the ring is that history, so there every sample is written and the range
+ * is applied on arrival. Deadband and predicate filters keep state or code,
+ * they only act in the subscribing process.
+ */
+
+// Scalar type of a wire field, as far as a filter needs to know it
+enum class WireScalar : std::uint8_t
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float,
+    Double,
+};
+
+template <typename F>
+constexpr WireScalar wireScalar()
+{
+    if constexpr (std::is_enum_v<F>)
+    {
+        return wireScalar<std::underlying_type_t<F>>();
+    }
+    else if constexpr (std::is_floating_point_v<F>)
+    {
+        static_assert(sizeof(F) == 4 || sizeof(F) == 8, "only float and double fields can be filtered");
+        return sizeof(F) == 4 ? WireScalar::Float : WireScalar::Double;
+    }
+    else
+    {
+        static_assert(std::is_integral_v<F> && sizeof(F) <= 8, "only scalar fields can be filtered");
+        constexpr int base = (sizeof(F) == 1) ? 0 : (sizeof(F) == 2) ? 2 : (sizeof(F) == 4) ? 4 : 6;
+        return static_cast<WireScalar>(base + (std::is_signed_v<F> ? 0 : 1));
+    }
+}
+
+// One field of a wire struct within [low, high]; a fixed layout, it is shared with other processes
+struct FieldRange
+{
+    std::uint32_t offset = 0;
+    WireScalar scalar = WireScalar::Int8;
+    std::uint8_t reserved[3]{};
+    double low = 0.0;
+    double high = 0.0;
+
+    // 64 bit integers beyond 2^53 compare with double precision
+    double valueIn(const void *payload) const
+    {
+        const auto *field = static_cast<const unsigned char *>(payload) + offset;
+        switch (scalar)
+        {
+        case WireScalar::Int8:
+            return load<std::int8_t>(field);
+        case WireScalar::UInt8:
+            return load<std::uint8_t>(field);
+        case WireScalar::Int16:
+            return load<std::int16_t>(field);
+        case WireScalar::UInt16:
+            return load<std::uint16_t>(field);
+        case WireScalar::Int32:
+            return load<std::int32_t>(field);
+        case WireScalar::UInt32:
+            return load<std::uint32_t>(field);
+        case WireScalar::Int64:
+            return static_cast<double>(load<std::int64_t>(field));
+        case WireScalar::UInt64:
+            return static_cast<double>(load<std::uint64_t>(field));
+        case WireScalar::Float:
+            return load<float>(field);
+        case WireScalar::Double:
+            return load<double>(field);
+        }
+        return 0.0;
+    }
+
+    bool accepts(const void *payload) const
+    {
+        const double value = valueIn(payload);
+        return value >= low && value <= high;
+    }
+
+    std::size_t fieldSize() const
+    {
+        switch (scalar)
+        {
+        case WireScalar::Int8:
+        case WireScalar::UInt8:
+            return 1;
+        case WireScalar::Int16:
+        case WireScalar::UInt16:
+            return 2;
+        case WireScalar::Int32:
+        case WireScalar::UInt32:
+        case WireScalar::Float:
+            return 4;
+        default:
+            return 8;
+        }
+    }
+
+private:
+    template <typename F>
+    static F load(const unsigned char *field)
+    {
+        F value;
+        std::memcpy(&value, field, sizeof(F));
+        return value;
+    }
+};
+static_assert(sizeof(FieldRange) == 24 && std::is_trivially_copyable_v<FieldRange>, "FieldRange is shared memory");
+
+// What a process still wants of a topic from other processes' publishers
+inline constexpr std::size_t kMaxInterestRanges = 4;
+struct SignalInterest
+{
+    bool all = true;       // every sample; otherwise those in at least one range
+    std::size_t count = 0; // of ranges, 0 with !all: none at all
+    std::array<FieldRange, kMaxInterestRanges> ranges{};
+};
+
+/*---Type erased filter of one subscription, see SignalFilter<T> for building one---*/
+class SubscriptionFilter
+{
+public:
+    enum class Kind : std::uint8_t
+    {
+        All,
+        Range,
+        Deadband,
+        Predicate,
+    };
+
+    Kind kind() const { return kind_; }
+    std::uint64_t fingerprint() const { return fingerprint_; } // of the payload type, 0 for All
+    const FieldRange &range() const { return field_; }         // Range and Deadband
+
+    // Called by publishers, concurrently; a deadband remembers what it let through
+    bool accepts(const void *payload) const
+    {
+        switch (kind_)
+        {
+        case Kind::All:
+            return true;
+        case Kind::Range:
+            return field_.accepts(payload);
+        case Kind::Deadband:
+            return passesDeadband(field_.valueIn(payload));
+        case Kind::Predicate:
+            return predicate_(function_, payload);
+        }
+        return true;
+    }
+
+protected:
+    Kind kind_ = Kind::All;
+    std::uint64_t fingerprint_ = 0;
+    FieldRange field_{}; // Deadband: low holds the delta
+    bool (*predicate_)(void (*function)(), const void *payload) = nullptr;
+    void (*function_)() = nullptr;
+
+private:
+    friend class SignalBus;
+
+    bool passesDeadband(double value) const
+    {
+        double last = last_->load(std::memory_order_relaxed);
+        do
+        {
+            if (!std::isnan(last) && std::fabs(value - last) < field_.low)
+            {
+                return false;
+            }
+        } while (!last_->compare_exchange_weak(last, value, std::memory_order_relaxed));
+        return true;
+    }
+
+    std::atomic<double> *last_ = nullptr; // Deadband: last sample let through, NaN at first; owned by the bus
+};
+
+template <typename Member>
+struct WireFieldOf;
+
+template <typename T, typename F>
+struct WireFieldOf<F T::*>
+{
+    using Struct = T;
+    using Field = F;
+};
+
+/*---Filter on the samples of payload type T---*/
+template <WireStruct T>
+class SignalFilter : public SubscriptionFilter
+{
+public:
+    // Samples whose Field lies within [low, high]
+    template <auto Field>
+    static SignalFilter range(double low, double high)
+    {
+        SignalFilter filter = onField<Field>(Kind::Range);
+        filter.field_.low = low;
+        filter.field_.high = high;
+        return filter;
+    }
+
+    template <auto Field>
+    static SignalFilter atLeast(double low)
+    {
+        return range<Field>(low, std::numeric_limits<double>::infinity());
+    }
+
+    // Samples whose Field moved at least delta away from the last one let through; the first always passes
+    template <auto Field>
+    static SignalFilter deadband(double delta)
+    {
+        SignalFilter filter = onField<Field>(Kind::Deadband);
+        filter.field_.low = delta;
+        return filter;
+    }
+
+    // Anything cheap enough to run on the publisher's thread, for every sample
+    static SignalFilter predicate(bool (*accept)(const T &signal))
+    {
+        SignalFilter filter;
+        filter.kind_ = Kind::Predicate;
+        filter.fingerprint_ = wireFingerprint<T>();
+        filter.function_ = reinterpret_cast<void (*)()>(accept);
+        filter.predicate_ = [](void (*function)(), const void *payload)
+        {
+            return reinterpret_cast<bool (*)(const T &)>(function)(*static_cast<const T *>(payload));
+        };
+        return filter;
+    }
+
+private:
+    template <auto Field>
+    static SignalFilter onField(Kind kind)
+    {
+        using Member = WireFieldOf<decltype(Field)>;
+        static_assert(std::is_same_v<typename Member::Struct, T>, "the field must be a member of the payload type");
+
+        static const T probe{};
+        SignalFilter filter;
+        filter.kind_ = kind;
+        filter.fingerprint_ = wireFingerprint<T>();
+        filter.field_.offset = static_cast<std::uint32_t>(reinterpret_cast<const unsigned char *>(&(probe.*Field)) -
+                                                          reinterpret_cast<const unsigned char *>(&probe));
+        filter.field_.scalar = wireScalar<typename Member::Field>();
+        return filter;
+    }
+};
+
+#endif // COMMON_FRAMEWORK_SIGNAL_FILTER_HPP
@@ -0,0 +1,155 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SignalHistory.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <thread>
+
+SignalHistory::SignalHistory(std::size_t payloadSize, std::size_t depth)
+    : payloadSize_(payloadSize),
+      depth_(std::clamp<std::size_t>(depth, 1, kMaxHistoryDepth)),
+      slots_(new unsigned char[payloadSize_ * depth_ * kWays]),
+      states_(new std::atomic<std::uint64_t>[depth_ * kWays]()),
+      generations_(new std::atomic<std::uint64_t>[depth_ * kWays]())
+{
+}
+
+std::size_t SignalHistory::wayOf(std::uint64_t sample) const
+{
+    const std::size_t first = (sample % depth_) * kWays;
+    for (std::size_t way = first; way < first + kWays; ++way)
+    {
+        if ((states_[way].load(std::memory_order_seq_cst) + 3) / 4 == sample + 1)
+        {
+            return way;
+        }
+    }
+    return kNoWay;
+}
+
+std::uint64_t SignalHistory::begin(const void *payloads, std::size_t count)
+{
+    const std::uint64_t first = head_.fetch_add(count, std::memory_order_seq_cst);
+    const std::size_t kept = std::min(count, depth_);
+    const auto *newest = static_cast<const unsigned char *>(payloads) + (count - kept) * payloadSize_;
+
+    for (std::uint64_t sample = first + count - kept; sample < first + count; ++sample, newest += payloadSize_)
+    {
+        // Replaces the oldest complete sample of the slot, never one being written or pinned
+        const std::size_t ways = (sample % depth_) * kWays;
+        for (;;)
+        {
+            std::size_t oldest = ways;
+            std::uint64_t oldestState = ~std::uint64_t{0};
+            for (std::size_t way = ways; way < ways + kWays; ++way)
+            {
+                const std::uint64_t state = states_[way].load(std::memory_order_relaxed);
+                if (state % 4 == 0 && state < oldestState)
+                {
+                    oldest = way;
+                    oldestState = state;
+                }
+            }
+            if (oldestState >= 4 * sample + 1)
+            {
+                break;
+            }
+            if (states_[oldest].compare_exchange_strong(oldestState, 4 * sample + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed))
+            {
+                std::atomic_thread_fence(std::memory_order_release);
+                std::memcpy(payload(oldest), newest, payloadSize_);
+                break;
+            }
+        }
+    }
+    return first;
+}
+
+void SignalHistory::finish(std::uint64_t first, std::size_t count, std::uint64_t generation)
+{
+    for (std::uint64_t sample = first + count - std::min(count, depth_); sample < first + count; ++sample)
+    {
+        // Nobody else moves a way on while it is marked as ours, copyMissed() only pins it
+        const std::size_t way = wayOf(sample);
+        if (way == kNoWay)
+        {
+            continue;
+        }
+        generations_[way].store(generation, std::memory_order_relaxed);
+        std::uint64_t writing = 4 * sample + 1;
+        if (!states_[way].compare_exchange_strong(writing, 4 * sample + 4, std::memory_order_release,
+                                                  std::memory_order_relaxed) &&
+            writing == 4 * sample + 3)
+        {
+            states_[way].store(4 * sample + 2, std::memory_order_release);
+        }
+    }
+}
+
+std::size_t SignalHistory::copyMissed(std::vector<std::max_align_t> &out, std::uint64_t generation)
+{
+    const std::uint64_t end = head_.load(std::memory_order_seq_cst);
+    const std::uint64_t start = end - std::min<std::uint64_t>(end, depth_);
+
+    // Pinned first, so the window is not overwritten while we wait for or copy the samples in it
+    std::array<std::size_t, kMaxHistoryDepth> pinned;
+    for (std::uint64_t sample = start; sample < end; ++sample)
+    {
+        // Not claimed yet: its publisher loads the list after us and delivers it live. Not kept: gone.
+        std::size_t way = wayOf(sample);
+        if (way != kNoWay)
+        {
+            // 4n+1 becomes 4n+3 and 4n+4 becomes 4n+2; finish() may complete the sample meanwhile
+            std::uint64_t state = states_[way].load(std::memory_order_seq_cst);
+            while ((state + 3) / 4 == sample + 1 &&
+                   !states_[way].compare_exchange_weak(state, (state % 4 == 1) ? state + 2 : state - 2,
+                                                       std::memory_order_seq_cst))
+            {
+            }
+            way = ((state + 3) / 4 == sample + 1) ? way : kNoWay;
+        }
+        pinned[sample - start] = way;
+    }
+
+    // max_align_t storage, so handlers read the samples in place as their signal type
+    out.resize((depth_ * payloadSize_ + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+    auto *target = reinterpret_cast<unsigned char *>(out.data());
+    std::size_t count = 0;
+    for (std::uint64_t sample = start; sample < end; ++sample)
+    {
+        const std::size_t way = pinned[sample - start];
+        if (way == kNoWay)
+        {
+            continue;
+        }
+        while (states_[way].load(std::memory_order_acquire) == 4 * sample + 3)
+        {
+            // Its publisher is between begin() and finish(), which run no handler
+            std::this_thread::yield();
+        }
+        if (generations_[way].load(std::memory_order_relaxed) != generation)
+        {
+            std::memcpy(target, payload(way), payloadSize_);
+            target += payloadSize_;
+            ++count;
+        }
+        states_[way].store(4 * sample + 4, std::memory_order_release);
+    }
+    return count;
+}
@@ -0,0 +1,71 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SIGNAL_HISTORY_HPP
+#define COMMON_FRAMEWORK_SIGNAL_HISTORY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+inline constexpr std::size_t kMaxHistoryDepth = 256; // samples a topic may keep for late subscribers
+
+/*---Last samples of a topic, in a ring allocated once; replayed to subscribers that join late---*/
+// Publishers write it without a lock: sample n claims one of the ways of slot n % depth, the one holding
+// the oldest complete sample, and marks it 4n+1 while written and 4n+4 once complete. A subscriber
+// being added pins the ways it replays (4n+3 while still written, 4n+2 once complete) so they are
+// not reused under it. The spare ways keep preempted writers and pins from costing later samples their slot.
+class SignalHistory
+{
+public:
+    // depth is clamped to 1..kMaxHistoryDepth
+    SignalHistory(std::size_t payloadSize, std::size_t depth);
+
+    SignalHistory(const SignalHistory &) = delete;
+    SignalHistory &operator=(const SignalHistory &) = delete;
+
+    std::size_t depth() const { return depth_; }
+
+    // Publisher side, from any thread. begin() claims count sample numbers for payloads laid out back
+    // to back and writes the newest depth() of them; they stay hidden until finish() marks them with
+    // the generation of the subscriber list the publisher loaded in between. Returns the first number.
+    // A sample whose slot has every way taken by newer or unfinished samples is not kept.
+    std::uint64_t begin(const void *payloads, std::size_t count);
+    void finish(std::uint64_t first, std::size_t count, std::uint64_t generation);
+
+    // Copies the newest samples whose publishers did not load subscriber list generation, oldest first
+    // and back to back into out; returns their count. Samples between begin() and finish() are waited for.
+    // One caller at a time.
+    std::size_t copyMissed(std::vector<std::max_align_t> &out, std::uint64_t generation);
+
+private:
+    static constexpr std::size_t kWays = 4;
+    static constexpr std::size_t kNoWay = ~std::size_t{0};
+
+    // Way of sample's slot whose state is 4 * sample + 1 to + 4, kNoWay if none
+    std::size_t wayOf(std::uint64_t sample) const;
+    unsigned char *payload(std::size_t way) const { return slots_.get() + way * payloadSize_; }
+
+    std::size_t payloadSize_;
+    std::size_t depth_;
+    std::unique_ptr<unsigned char[]> slots_; // kWays payloads per slot, sample n in slot n % depth_
+    std::unique_ptr<std::atomic<std::uint64_t>[]> states_;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> generations_; // list generation each way's publisher loaded
+    std::atomic<std::uint64_t> head_{0};                         // next sample number to claim
+};
+
+#endif // COMMON_FRAMEWORK_SIGNAL_HISTORY_HPP
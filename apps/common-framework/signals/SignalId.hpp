@@ -0,0 +1,27 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SIGNAL_ID_HPP
+#define COMMON_FRAMEWORK_SIGNAL_ID_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/*---Dense per-process topic ID, index into the SignalBus subscriber table---*/
+using SignalId = std::uint32_t;
+inline constexpr SignalId kInvalidSignalId = UINT32_MAX;
+inline constexpr std::size_t kMaxSignals = 256; // Capacity of the flat subscriber table
+
+#endif // COMMON_FRAMEWORK_SIGNAL_ID_HPP
@@ -0,0 +1,328 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SignalMetrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+using Counter = std::atomic<std::uint64_t>;
+
+// A counter has a single writer, the thread owning the slot: a load and a store, no read-modify-write
+void bump(Counter &counter, std::uint64_t amount)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+struct SubscriberCounters
+{
+    Counter delivered;
+    Counter handlerNsTotal;
+    Counter handlerNsMax;
+    Counter queueNsTotal;
+    std::array<Counter, kLatencyBuckets> handlerTime;
+    std::array<Counter, kLatencyBuckets> queueDelay;
+};
+
+struct alignas(64) ThreadSlot
+{
+    std::array<Counter, kMaxSignals> published;
+    std::array<Counter, kMaxSignals> received;
+    std::array<SubscriberCounters, kMaxMetricSubscribers> subscribers;
+};
+
+// Never freed: threads may still count after the bus is gone
+struct SlotRegistry
+{
+    std::mutex mutex;
+    std::vector<ThreadSlot *> slots;
+    std::vector<ThreadSlot *> unused; // of threads that exited
+};
+
+SlotRegistry &registry()
+{
+    static SlotRegistry *instance = new SlotRegistry;
+    return *instance;
+}
+
+struct SlotLease
+{
+    ThreadSlot *slot = nullptr;
+
+    ~SlotLease()
+    {
+        if (slot != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            registry().unused.push_back(slot);
+        }
+    }
+};
+
+thread_local SlotLease lease;
+
+ThreadSlot &localSlot()
+{
+    if (lease.slot == nullptr)
+    {
+        SlotRegistry &slots = registry();
+        std::lock_guard<std::mutex> lock(slots.mutex);
+        if (!slots.unused.empty())
+        {
+            lease.slot = slots.unused.back();
+            slots.unused.pop_back();
+        }
+        else
+        {
+            lease.slot = new ThreadSlot();
+            slots.slots.push_back(lease.slot);
+        }
+    }
+    return *lease.slot;
+}
+
+std::size_t bucketOf(std::int64_t ns)
+{
+    const auto scaled = static_cast<std::uint64_t>(std::max<std::int64_t>(ns, 0)) >> 8;
+    return std::min<std::size_t>(std::bit_width(scaled), kLatencyBuckets - 1);
+}
+
+void add(LatencyHistogram &histogram, const std::array<Counter, kLatencyBuckets> &counters)
+{
+    for (std::size_t i = 0; i < kLatencyBuckets; ++i)
+    {
+        histogram[i] += counters[i].load(std::memory_order_relaxed);
+    }
+}
+
+const char *modeName(DeliveryMode mode)
+{
+    switch (mode)
+    {
+    case DeliveryMode::Inline:
+        return "inline";
+    case DeliveryMode::Dedicated:
+        return "dedicated";
+    case DeliveryMode::Pool:
+        return "pool";
+    case DeliveryMode::Polled:
+        return "polled";
+    }
+    return "?";
+}
+} // namespace
+
+std::uint64_t latencyPercentile(const LatencyHistogram &histogram, double quantile)
+{
+    std::uint64_t total = 0;
+    for (std::uint64_t count : histogram)
+    {
+        total += count;
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(quantile * static_cast<double>(total)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kLatencyBuckets; ++i)
+    {
+        seen += histogram[i];
+        if (seen >= rank)
+        {
+            return std::uint64_t{256} << i;
+        }
+    }
+    return std::uint64_t{256} << (kLatencyBuckets - 1);
+}
+
+void SignalBusMetrics::print(std::ostream &out) const
+{
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+    out << std::left << std::setw(44) << "topic" << std::right << std::setw(12) << "published" << std::setw(12)
+        << "received" << std::setw(12) << "delivered" << std::setw(10) << "dropped" << '\n';
+    for (const TopicMetrics &topic : topics)
+    {
+        if (topic.published == 0 && topic.received == 0 && topic.delivered == 0)
+        {
+            continue;
+        }
+        out << std::left << std::setw(44) << topic.name << std::right << std::setw(12) << topic.published
+            << std::setw(12) << topic.received << std::setw(12) << topic.delivered << std::setw(10) << topic.dropped
+            << '\n';
+    }
+
+    // Percentiles are bucket bounds: the true value lies within a factor of two below
+    out << std::left << std::setw(44) << "subscriber" << std::setw(10) << "mode" << std::right << std::setw(12)
+        << "delivered" << std::setw(10) << "dropped" << std::setw(28) << "handler p50/p99/max us" << std::setw(20)
+        << "queue p50/p99 us" << std::setw(12) << "over budget" << '\n';
+    for (const SubscriberMetrics &subscriber : subscribers)
+    {
+        std::ostringstream handler;
+        handler << std::fixed << std::setprecision(1) << us(latencyPercentile(subscriber.handlerTime, 0.5)) << '/'
+                << us(latencyPercentile(subscriber.handlerTime, 0.99)) << '/' << us(subscriber.handlerNsMax);
+        std::ostringstream queue;
+        if (subscriber.mode == DeliveryMode::Inline)
+        {
+            queue << '-';
+        }
+        else
+        {
+            queue << std::fixed << std::setprecision(1) << us(latencyPercentile(subscriber.queueDelay, 0.5)) << '/'
+                  << us(latencyPercentile(subscriber.queueDelay, 0.99));
+        }
+
+        std::ostringstream name;
+        name << subscriber.topic << '@' << subscriber.instance << (subscriber.active ? " " : " (gone) ");
+        out << std::left << std::setw(44) << name.str() << std::setw(10) << modeName(subscriber.mode) << std::right
+            << std::setw(12) << subscriber.delivered << std::setw(10) << subscriber.dropped << std::setw(28)
+            << handler.str() << std::setw(20) << queue.str() << std::setw(12) << subscriber.overBudget
+            << (subscriber.overBudget > 0 ? "  SLOW" : "") << '\n';
+    }
+    out << std::flush;
+}
+
+std::uint16_t SignalMetrics::addSubscriber(SignalId signalId, const std::string &topic, const void *instance,
+                                           DeliveryMode mode, std::chrono::nanoseconds budget)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const std::size_t count = numSubscribers_.load(std::memory_order_relaxed);
+    if (count >= kMaxMetricSubscribers)
+    {
+        return kNoMetrics;
+    }
+    info_[count] = SubscriberInfo{signalId, topic, instance, mode, budget.count()};
+    active_[count].store(true, std::memory_order_relaxed);
+    numSubscribers_.store(count + 1, std::memory_order_release);
+    return static_cast<std::uint16_t>(count);
+}
+
+void SignalMetrics::deactivate(const void *instance)
+{
+    const std::size_t count = numSubscribers_.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (info_[i].instance == instance)
+        {
+            active_[i].store(false, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SignalMetrics::countPublished(SignalId signalId, std::size_t count)
+{
+    bump(localSlot().published[signalId], count);
+}
+
+void SignalMetrics::countReceived(SignalId signalId)
+{
+    bump(localSlot().received[signalId], 1);
+}
+
+void SignalMetrics::countDelivery(std::uint16_t subscriber, std::int64_t handlerNs, std::int64_t queueNs)
+{
+    SubscriberCounters &counters = localSlot().subscribers[subscriber];
+    const auto handler = static_cast<std::uint64_t>(std::max<std::int64_t>(handlerNs, 0));
+
+    bump(counters.delivered, 1);
+    bump(counters.handlerNsTotal, handler);
+    bump(counters.handlerTime[bucketOf(handlerNs)], 1);
+    if (handler > counters.handlerNsMax.load(std::memory_order_relaxed))
+    {
+        counters.handlerNsMax.store(handler, std::memory_order_relaxed);
+    }
+    if (queueNs >= 0)
+    {
+        bump(counters.queueNsTotal, static_cast<std::uint64_t>(queueNs));
+        bump(counters.queueDelay[bucketOf(queueNs)], 1);
+    }
+
+    // Published with the subscriber list this subscriber was found in, no lock needed
+    const SubscriberInfo &info = info_[subscriber];
+    if (info.budgetNs > 0 && handlerNs > info.budgetNs)
+    {
+        const std::uint64_t times = overBudget_[subscriber].fetch_add(1, std::memory_order_relaxed) + 1;
+        if (std::has_single_bit(times))
+        {
+            std::cerr << "SignalBus Warning: Subscriber " << info.instance << " of '" << info.topic << "' took "
+                      << handlerNs / 1000 << " us, budget " << info.budgetNs / 1000 << " us (" << times
+                      << " times over)" << std::endl;
+        }
+    }
+}
+
+SignalBusMetrics SignalMetrics::collect(std::size_t numSignals) const
+{
+    SignalBusMetrics result;
+    result.topics.resize(numSignals);
+    for (std::size_t i = 0; i < numSignals; ++i)
+    {
+        result.topics[i].signalId = static_cast<SignalId>(i);
+    }
+
+    const std::size_t numSubscribers = numSubscribers_.load(std::memory_order_acquire);
+    result.subscribers.resize(numSubscribers);
+    for (std::size_t i = 0; i < numSubscribers; ++i)
+    {
+        SubscriberMetrics &subscriber = result.subscribers[i];
+        subscriber.signalId = info_[i].signalId;
+        subscriber.topic = info_[i].topic;
+        subscriber.instance = info_[i].instance;
+        subscriber.mode = info_[i].mode;
+        subscriber.active = active_[i].load(std::memory_order_relaxed);
+        subscriber.budget = std::chrono::nanoseconds(info_[i].budgetNs);
+        subscriber.overBudget = overBudget_[i].load(std::memory_order_relaxed);
+    }
+
+    SlotRegistry &slots = registry();
+    std::lock_guard<std::mutex> lock(slots.mutex);
+    for (const ThreadSlot *slot : slots.slots)
+    {
+        for (std::size_t i = 0; i < numSignals; ++i)
+        {
+            result.topics[i].published += slot->published[i].load(std::memory_order_relaxed);
+            result.topics[i].received += slot->received[i].load(std::memory_order_relaxed);
+        }
+        for (std::size_t i = 0; i < numSubscribers; ++i)
+        {
+            const SubscriberCounters &counters = slot->subscribers[i];
+            SubscriberMetrics &subscriber = result.subscribers[i];
+            subscriber.delivered += counters.delivered.load(std::memory_order_relaxed);
+            subscriber.handlerNsTotal += counters.handlerNsTotal.load(std::memory_order_relaxed);
+            subscriber.handlerNsMax =
+                std::max(subscriber.handlerNsMax, counters.handlerNsMax.load(std::memory_order_relaxed));
+            subscriber.queueNsTotal += counters.queueNsTotal.load(std::memory_order_relaxed);
+            add(subscriber.handlerTime, counters.handlerTime);
+            add(subscriber.queueDelay, counters.queueDelay);
+        }
+    }
+
+    for (const SubscriberMetrics &subscriber : result.subscribers)
+    {
+        if (subscriber.signalId < numSignals)
+        {
+            result.topics[subscriber.signalId].delivered += subscriber.delivered;
+        }
+    }
+    return result;
+}
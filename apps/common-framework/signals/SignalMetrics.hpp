@@ -0,0 +1,129 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_SIGNAL_METRICS_HPP
+#define COMMON_FRAMEWORK_SIGNAL_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "SignalExecutor.hpp"
+#include "SignalId.hpp"
+
+// Log2 buckets: bucket 0 counts below 256 ns, bucket i [128 << i, 256 << i) ns, the last one 4 ms and up
+inline constexpr std::size_t kLatencyBuckets = 16;
+using LatencyHistogram = std::array<std::uint64_t, kLatencyBuckets>;
+
+// Upper bound in ns of the bucket holding the quantile, 0 for an empty histogram
+std::uint64_t latencyPercentile(const LatencyHistogram &histogram, double quantile);
+
+inline constexpr std::size_t kMaxMetricSubscribers = 128; // subscriptions counted, later ones are not
+inline constexpr std::uint16_t kNoMetrics = UINT16_MAX;
+
+struct TopicMetrics
+{
+    SignalId signalId = kInvalidSignalId;
+    std::string name;
+    std::uint64_t published = 0; // by this process
+    std::uint64_t received = 0;  // from other processes
+    std::uint64_t delivered = 0; // handler calls, summed over the topic's subscribers
+    std::uint64_t dropped = 0;   // discarded or overwritten in full subscriber queues
+};
+
+struct SubscriberMetrics
+{
+    SignalId signalId = kInvalidSignalId;
+    std::string topic;
+    const void *instance = nullptr; // identifies the subscriber, may be gone if !active
+    DeliveryMode mode = DeliveryMode::Inline;
+    bool active = true;
+    std::chrono::nanoseconds budget{0};
+    std::uint64_t delivered = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t overBudget = 0; // handler calls that took longer than budget
+    std::uint64_t handlerNsTotal = 0;
+    std::uint64_t handlerNsMax = 0;
+    std::uint64_t queueNsTotal = 0;
+    LatencyHistogram handlerTime{};
+    LatencyHistogram queueDelay{}; // publish to handler entry, queued subscribers only
+};
+
+/*---What SignalBus::metrics() returns: totals since start, summed over every thread---*/
+struct SignalBusMetrics
+{
+    std::vector<TopicMetrics> topics;
+    std::vector<SubscriberMetrics> subscribers;
+
+    // One line per topic with traffic and per subscriber; subscribers over budget are marked SLOW
+    void print(std::ostream &out) const;
+};
+
+/*
+ * Counters of the SignalBus. Each thread writes a cache line aligned slot of
+ * its own with plain relaxed stores, no locked instruction and no line shared
+ * with another writer; collect() sums the slots. A slot outlives its thread and
+ * is handed to the next one, so totals never go backwards.
+ */
+class SignalMetrics
+{
+public:
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // Registers a subscription, kNoMetrics once kMaxMetricSubscribers are registered
+    std::uint16_t addSubscriber(SignalId signalId, const std::string &topic, const void *instance, DeliveryMode mode,
+                                std::chrono::nanoseconds budget);
+    void deactivate(const void *instance);
+
+    void countPublished(SignalId signalId, std::size_t count);
+    void countReceived(SignalId signalId);
+
+    // One handler call; queueNs < 0 for inline subscribers. Warns when the budget is exceeded
+    // the 1st, 2nd, 4th, 8th... time, so a slow subscriber is flagged without flooding the log.
+    void countDelivery(std::uint16_t subscriber, std::int64_t handlerNs, std::int64_t queueNs);
+
+    // Totals of the first numSignals topics, subscribers indexed by their ID; topic names and drops
+    // are the bus's to fill in
+    SignalBusMetrics collect(std::size_t numSignals) const;
+
+private:
+    struct SubscriberInfo
+    {
+        SignalId signalId;
+        std::string topic;
+        const void *instance;
+        DeliveryMode mode;
+        std::int64_t budgetNs; // 0: no budget
+    };
+
+    std::array<SubscriberInfo, kMaxMetricSubscribers> info_{};
+    std::array<std::atomic<bool>, kMaxMetricSubscribers> active_{};
+    std::array<std::atomic<std::uint64_t>, kMaxMetricSubscribers> overBudget_{}; // only written when over budget
+    std::atomic<std::size_t> numSubscribers_{0}; // info_ below it is complete
+    std::mutex mutex_;
+};
+
+#endif // COMMON_FRAMEWORK_SIGNAL_METRICS_HPP
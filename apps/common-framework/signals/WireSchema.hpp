@@ -0,0 +1,137 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_WIRE_SCHEMA_HPP
+#define COMMON_FRAMEWORK_WIRE_SCHEMA_HPP
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <type_traits>
+
+/*
+ * Wire structs: the in-memory form of a signal is its wire form.
+ *
+ * A signal is declared from a schema, a list of fields:
+ *
+ *   #define SPEED_SIGNAL_FIELDS(FIELD) \
+ *       FIELD(std::int32_t, speed_kmph)
+ *   SIGNAL_WIRE_STRUCT(SpeedSignal, 1, SPEED_SIGNAL_FIELDS);
+ *
+ * The macro generates the struct and checks at compile time that it is
+ * trivially copyable and has no implicit padding, so its layout is the same in
+ * every process. Fields are scalars, enums or std::arrays of them in host byte
+ * order (give an std::array a type alias, the comma would split the macro
+ * argument). Changing the field list or bumping the version changes the
+ * schema fingerprint; transports refuse to connect peers whose fingerprints differ.
+ */
+
+static_assert(std::endian::native == std::endian::little, "wire structs are exchanged in little endian byte order");
+
+// FNV-1a, usable in constant expressions
+constexpr std::uint64_t fnv1a64(std::string_view text, std::uint64_t hash = 14695981039346656037ULL)
+{
+    for (char c : text)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+struct IsWireField : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>>
+{
+};
+
+template <typename T, std::size_t N>
+struct IsWireField<std::array<T, N>> : IsWireField<T>
+{
+};
+
+template <typename T>
+concept WireStruct = std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T> && requires {
+    { T::kWireVersion } -> std::convertible_to<std::uint16_t>;
+    { T::kWireSchema } -> std::convertible_to<std::string_view>;
+};
+
+// Identifies schema and version: both are hashed, the version's two bytes first. 0 is never a valid fingerprint.
+constexpr std::uint64_t schemaFingerprint(std::string_view schema, std::uint16_t version)
+{
+    const char versionBytes[] = {static_cast<char>(version & 0xFFU), static_cast<char>(version >> 8)};
+    const std::uint64_t hash = fnv1a64(schema, fnv1a64(std::string_view(versionBytes, sizeof(versionBytes))));
+    return (hash != 0) ? hash : 14695981039346656037ULL;
+}
+
+static_assert(schemaFingerprint("S{std::int32_t x;}", 2) != schemaFingerprint("S{std::int32_t x;}", 3),
+              "a version bump must change the fingerprint");
+
+template <WireStruct T>
+constexpr std::uint64_t wireFingerprint()
+{
+    return schemaFingerprint(T::kWireSchema, T::kWireVersion);
+}
+
+template <WireStruct T>
+inline void wireEncode(const T &value, void *out)
+{
+    std::memcpy(out, &value, sizeof(T));
+}
+
+template <WireStruct T>
+inline bool wireDecode(const void *bytes, std::size_t size, T &out)
+{
+    if (size != sizeof(T))
+    {
+        return false;
+    }
+    std::memcpy(&out, bytes, sizeof(T));
+    return true;
+}
+
+// Reads a message where it lies; nullptr if the size is wrong or the buffer is misaligned for T
+template <WireStruct T>
+inline const T *wireView(const void *bytes, std::size_t size)
+{
+    if (size != sizeof(T) || reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) != 0)
+    {
+        return nullptr;
+    }
+    return std::launder(static_cast<const T *>(bytes));
+}
+
+#define SIGNAL_WIRE_MEMBER(type, name) type name;
+#define SIGNAL_WIRE_SIZE(type, name) +sizeof(type)
+#define SIGNAL_WIRE_TEXT(type, name) #type " " #name ";"
+#define SIGNAL_WIRE_CHECK(type, name)                                                                                  \
+    static_assert(IsWireField<type>::value, "wire field '" #name "' must be a scalar, an enum or an std::array of them");
+
+#define SIGNAL_WIRE_STRUCT(Name, Version, FIELDS)                                                                      \
+    struct Name                                                                                                        \
+    {                                                                                                                  \
+        FIELDS(SIGNAL_WIRE_MEMBER)                                                                                     \
+        static constexpr std::uint16_t kWireVersion = Version;                                                         \
+        static constexpr std::string_view kWireSchema = #Name "{" FIELDS(SIGNAL_WIRE_TEXT) "}";                        \
+    };                                                                                                                 \
+    FIELDS(SIGNAL_WIRE_CHECK)                                                                                          \
+    static_assert(WireStruct<Name>, #Name " must be trivially copyable with standard layout");                         \
+    static_assert(sizeof(Name) == 0 FIELDS(SIGNAL_WIRE_SIZE), #Name " has padding, order the fields by size")
+
+#endif // COMMON_FRAMEWORK_WIRE_SCHEMA_HPP
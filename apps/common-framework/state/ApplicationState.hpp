@@ -42,4 +42,57 @@ enum class AppEvent {
     TICK               // Periodic tick event (for execute loop)
 };
 
+// Names for logs and traces
+inline const char *appStateName(AppState state)
+{
+    switch (state)
+    {
+    case AppState::UNINITIALIZED:
+        return "UNINITIALIZED";
+    case AppState::INITIALIZING:
+        return "INITIALIZING";
+    case AppState::READY:
+        return "READY";
+    case AppState::RUNNING:
+        return "RUNNING";
+    case AppState::PAUSED:
+        return "PAUSED";
+    case AppState::ERROR:
+        return "ERROR";
+    case AppState::TERMINATING:
+        return "TERMINATING";
+    case AppState::TERMINATED:
+        return "TERMINATED";
+    }
+    return "?";
+}
+
+inline const char *appEventName(AppEvent event)
+{
+    switch (event)
+    {
+    case AppEvent::INIT_REQUEST:
+        return "INIT_REQUEST";
+    case AppEvent::INIT_SUCCESS:
+        return "INIT_SUCCESS";
+    case AppEvent::INIT_FAIL:
+        return "INIT_FAIL";
+    case AppEvent::START_REQUEST:
+        return "START_REQUEST";
+    case AppEvent::PAUSE_REQUEST:
+        return "PAUSE_REQUEST";
+    case AppEvent::RESUME_REQUEST:
+        return "RESUME_REQUEST";
+    case AppEvent::STOP_REQUEST:
+        return "STOP_REQUEST";
+    case AppEvent::ERROR_OCCURRED:
+        return "ERROR_OCCURRED";
+    case AppEvent::SHUTDOWN_REQUEST:
+        return "SHUTDOWN_REQUEST";
+    case AppEvent::TICK:
+        return "TICK";
+    }
+    return "?";
+}
+
 #endif // COMMON_FRAMEWORK_APPLICATION_STATE_HPP
\ No newline at end of file
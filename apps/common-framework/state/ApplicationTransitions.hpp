@@ -0,0 +1,52 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_APPLICATION_TRANSITIONS_HPP
+#define COMMON_FRAMEWORK_APPLICATION_TRANSITIONS_HPP
+
+#include "ApplicationState.hpp"
+#include "TableStateMachine.hpp"
+
+template <>
+inline constexpr std::size_t kEnumCount<AppState> = static_cast<std::size_t>(AppState::TERMINATED) + 1;
+template <>
+inline constexpr std::size_t kEnumCount<AppEvent> = static_cast<std::size_t>(AppEvent::TICK) + 1;
+
+// The application lifecycle of CommonApplicationStates.cpp as a table, for TableStateMachine
+inline constexpr auto kApplicationTransitions = makeTransitionTable<AppState, AppEvent>(
+    AppState::UNINITIALIZED, {AppState::TERMINATED},
+    {
+        {AppState::UNINITIALIZED, AppEvent::INIT_REQUEST, AppState::INITIALIZING},
+        {AppState::INITIALIZING, AppEvent::INIT_SUCCESS, AppState::READY},
+        {AppState::INITIALIZING, AppEvent::INIT_FAIL, AppState::ERROR},
+        {AppState::READY, AppEvent::START_REQUEST, AppState::RUNNING},
+        {AppState::READY, AppEvent::SHUTDOWN_REQUEST, AppState::TERMINATING},
+        {AppState::RUNNING, AppEvent::PAUSE_REQUEST, AppState::PAUSED},
+        {AppState::RUNNING, AppEvent::STOP_REQUEST, AppState::TERMINATING},
+        {AppState::RUNNING, AppEvent::SHUTDOWN_REQUEST, AppState::TERMINATING},
+        {AppState::RUNNING, AppEvent::ERROR_OCCURRED, AppState::ERROR},
+        {AppState::PAUSED, AppEvent::RESUME_REQUEST, AppState::RUNNING},
+        {AppState::PAUSED, AppEvent::SHUTDOWN_REQUEST, AppState::TERMINATING},
+        {AppState::ERROR, AppEvent::SHUTDOWN_REQUEST, AppState::TERMINATING},
+        completion(AppState::TERMINATING, AppState::TERMINATED),
+    });
+
+// Checked here as well as by TableStateMachine, so the table is verified even while nothing runs it
+static_assert(kApplicationTransitions.inRange() && kApplicationTransitions.unambiguous() &&
+                  kApplicationTransitions.allReachable() && kApplicationTransitions.noDeadEnds() &&
+                  kApplicationTransitions.completionsTerminate(),
+              "kApplicationTransitions is not a valid transition table");
+
+#endif // COMMON_FRAMEWORK_APPLICATION_TRANSITIONS_HPP
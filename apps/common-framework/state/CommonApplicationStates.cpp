@@ -14,6 +14,7 @@
  */
 
 #include <iostream>
+#include "ApplicationTransitions.hpp" // the same lifecycle as a table, its static_asserts run here
 #include "CommonApplicationStates.hpp"
 #include "StateMachine.hpp"
 
@@ -40,7 +41,7 @@ void InitializingState::enter(IStateMachine<AppState, AppEvent> &sm)
 {
     std::cout << "App State: Entering InitializingState" << std::endl;
     /* Intialization tasks to be added */
-    sm.handleEvent(AppEvent::INIT_SUCCESS);
+    sm.post(AppEvent::INIT_SUCCESS); // handled once this transition is complete
 }
 
 void InitializingState::exit(IStateMachine<AppState, AppEvent> &sm) {}
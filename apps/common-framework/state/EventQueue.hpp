@@ -0,0 +1,103 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_EVENT_QUEUE_HPP
+#define COMMON_FRAMEWORK_EVENT_QUEUE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Bounded lock free queue, any number of producers and one consumer. Each cell
+ * carries a sequence number telling whose turn it is, so a producer claims a
+ * cell with a single CAS and the consumer needs none. Nothing is allocated
+ * and nothing blocks, so push() is safe from any thread, including an OS
+ * signal handler; it returns false when the queue is full.
+ */
+template <typename T, std::size_t Capacity>
+class EventQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    EventQueue()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+
+    // Any thread; false if the queue is full
+    bool push(const T &value)
+    {
+        std::size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells_[position & (Capacity - 1)];
+            const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (lag == 0)
+            {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value = value;
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (lag < 0)
+            {
+                return false; // the consumer has not freed the cell of the previous lap
+            }
+            else
+            {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only; false if nothing is queued, or the oldest push is still being written
+    bool pop(T &value)
+    {
+        Cell &cell = cells_[head_ & (Capacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != head_ + 1)
+        {
+            return false;
+        }
+        value = cell.value;
+        cell.sequence.store(head_ + Capacity, std::memory_order_release);
+        ++head_;
+        return true;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::array<Cell, Capacity> cells_;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::size_t head_ = 0;
+};
+
+#endif // COMMON_FRAMEWORK_EVENT_QUEUE_HPP
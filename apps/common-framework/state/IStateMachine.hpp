@@ -29,6 +29,7 @@ public:
     virtual void addState(StateEnum type, std::unique_ptr<IState<StateEnum, EventEnum>> state) = 0;
     virtual void transitionTo(StateEnum newStateEnum) = 0;
     virtual void handleEvent(EventEnum event) = 0;
+    virtual void post(EventEnum event) = 0;
     virtual StateEnum getCurrentState() const = 0;
 };
 
@@ -25,7 +25,7 @@ void StateMachine<StateEnum, EventEnum>::addState(StateEnum type, std::unique_pt
 {
     states_[type] = std::move(state);
     // If this is the initial state being added, set current state pointer
-    if (type == currentStateEnum_ && !currentState_)
+    if (type == currentStateEnum_.load(std::memory_order_relaxed) && !currentState_)
     {
         currentState_ = states_[type].get();
     }
@@ -34,19 +34,37 @@ void StateMachine<StateEnum, EventEnum>::addState(StateEnum type, std::unique_pt
 template <typename StateEnum, typename EventEnum>
 void StateMachine<StateEnum, EventEnum>::transitionTo(StateEnum newStateEnum)
 {
+    [[maybe_unused]] const StateEnum previous = currentStateEnum_.load(std::memory_order_relaxed);
+    [[maybe_unused]] std::int64_t startNs = 0;
+    [[maybe_unused]] std::int64_t exitedNs = 0;
+    if constexpr (kStateMachineTrace)
+    {
+        startNs = TransitionTrace::now();
+    }
+
     if (currentState_)
     {
         // std::cout << "State Machine: Exiting " << static_cast<int>(currentStateEnum_) << std::endl;
         currentState_->exit(*this);
     }
+    if constexpr (kStateMachineTrace)
+    {
+        exitedNs = TransitionTrace::now();
+    }
 
     auto it = states_.find(newStateEnum);
     if (it != states_.end())
     {
         currentState_ = it->second.get();
-        currentStateEnum_ = newStateEnum;
+        currentStateEnum_.store(newStateEnum, std::memory_order_release);
         // std::cout << "State Machine: Entering " << static_cast<int>(newStateEnum) << std::endl;
         currentState_->enter(*this);
+
+        if constexpr (kStateMachineTrace)
+        {
+            TransitionTrace::instance().record({this, static_cast<int>(previous), static_cast<int>(newStateEnum),
+                                                tracedEvent_, startNs, exitedNs, TransitionTrace::now()});
+        }
     }
     else
     {
@@ -58,6 +76,79 @@ void StateMachine<StateEnum, EventEnum>::transitionTo(StateEnum newStateEnum)
 template <typename StateEnum, typename EventEnum>
 void StateMachine<StateEnum, EventEnum>::handleEvent(EventEnum event)
 {
+    if (dispatching_)
+    {
+        post(event);
+        return;
+    }
+
+    dispatching_ = true;
+    dispatch(event);
+    EventEnum next;
+    while (posted_.pop(next))
+    {
+        dispatch(next);
+    }
+    dispatching_ = false;
+    reportDrops();
+}
+
+template <typename StateEnum, typename EventEnum>
+void StateMachine<StateEnum, EventEnum>::post(EventEnum event)
+{
+    // Nothing but lock free atomics here, a signal handler may be the caller
+    if (!posted_.push(event))
+    {
+        droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename StateEnum, typename EventEnum>
+std::size_t StateMachine<StateEnum, EventEnum>::droppedEvents() const
+{
+    return droppedEvents_.load(std::memory_order_relaxed);
+}
+
+template <typename StateEnum, typename EventEnum>
+void StateMachine<StateEnum, EventEnum>::reportDrops()
+{
+    const std::size_t dropped = droppedEvents_.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops_)
+    {
+        std::cerr << "State Machine Error: Event queue full, dropped " << (dropped - reportedDrops_)
+                  << " posted events (" << dropped << " in total)" << std::endl;
+        reportedDrops_ = dropped;
+    }
+}
+
+template <typename StateEnum, typename EventEnum>
+std::size_t StateMachine<StateEnum, EventEnum>::processPosted()
+{
+    if (dispatching_)
+    {
+        return 0; // the running handleEvent() drains the queue
+    }
+
+    std::size_t handled = 0;
+    dispatching_ = true;
+    EventEnum next;
+    while (posted_.pop(next))
+    {
+        dispatch(next);
+        ++handled;
+    }
+    dispatching_ = false;
+    reportDrops();
+    return handled;
+}
+
+template <typename StateEnum, typename EventEnum>
+void StateMachine<StateEnum, EventEnum>::dispatch(EventEnum event)
+{
+    if constexpr (kStateMachineTrace)
+    {
+        tracedEvent_ = static_cast<int>(event);
+    }
     if (currentState_)
     {
         currentState_->handleEvent(*this, event);
@@ -67,12 +158,16 @@ void StateMachine<StateEnum, EventEnum>::handleEvent(EventEnum event)
         // std::cerr << "State Machine Warning: Event " << static_cast<int>(event)
         //           << " received, but no current state is set." << std::endl;
     }
+    if constexpr (kStateMachineTrace)
+    {
+        tracedEvent_ = kNoTraceEvent;
+    }
 }
 
 template <typename StateEnum, typename EventEnum>
 StateEnum StateMachine<StateEnum, EventEnum>::getCurrentState() const
 {
-    return currentStateEnum_;
+    return currentStateEnum_.load(std::memory_order_acquire);
 }
 
 // Explicit instantiations for common usage
@@ -16,28 +16,64 @@
 #ifndef COMMON_FRAMEWORK_STATE_MACHINE_HPP
 #define COMMON_FRAMEWORK_STATE_MACHINE_HPP
 
+#include <atomic>
+#include <cstddef>
 #include <map>
 #include <memory>
 
 #include "IStateMachine.hpp"
 #include "IState.hpp"
 #include "ApplicationState.hpp"
+#include "EventQueue.hpp"
+#include "TransitionTrace.hpp"
 
-
+/*
+ * Events run to completion on one owner thread, the one calling handleEvent()
+ * and processPosted(). Other threads post() events, which are queued without
+ * a lock; events raised while one is handled, e.g. from a state's enter(), are
+ * queued behind it instead of being handled recursively.
+ *
+ * Built with STATE_MACHINE_TRACE, every transition is recorded with its event
+ * and the time exit() and enter() took (see TransitionTrace.hpp).
+ */
 template<typename StateEnum, typename EventEnum>
 class StateMachine : public IStateMachine<StateEnum, EventEnum> {
 public:
+    static constexpr std::size_t kEventQueueCapacity = 64;
+
     explicit StateMachine(StateEnum initialState);
 
     void addState(StateEnum type, std::unique_ptr<IState<StateEnum, EventEnum>> state) override;
     void transitionTo(StateEnum newStateEnum) override;
+
+    // Owner thread: handles the event, then whatever was posted until the queue is empty
     void handleEvent(EventEnum event) override;
+
+    // Any thread, also an OS signal handler: queues the event for the owner thread. If the queue is
+    // full the event is dropped and counted; the owner thread reports drops when it next handles events.
+    void post(EventEnum event) override;
+
+    // Owner thread: handles the posted events, returns how many
+    std::size_t processPosted();
+
+    // Any thread: events post() dropped so far
+    std::size_t droppedEvents() const;
+
+    // Any thread
     StateEnum getCurrentState() const override;
 
 private:
-    StateEnum currentStateEnum_;
+    void dispatch(EventEnum event);
+    void reportDrops();
+
+    std::atomic<StateEnum> currentStateEnum_;
     IState<StateEnum, EventEnum>* currentState_ = nullptr; // Raw pointer to current state (owned by map)
     std::map<StateEnum, std::unique_ptr<IState<StateEnum, EventEnum>>> states_;
+    EventQueue<EventEnum, kEventQueueCapacity> posted_;
+    std::atomic<std::size_t> droppedEvents_{0};
+    std::size_t reportedDrops_ = 0; // owner thread only
+    bool dispatching_ = false; // owner thread only
+    int tracedEvent_ = kNoTraceEvent; // being handled, for the trace
 };
 
 #endif // COMMON_FRAMEWORK_STATE_MACHINE_HPP
\ No newline at end of file
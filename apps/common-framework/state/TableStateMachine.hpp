@@ -0,0 +1,329 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_TABLE_STATE_MACHINE_HPP
+#define COMMON_FRAMEWORK_TABLE_STATE_MACHINE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * State machine whose transitions are a constexpr table instead of IState
+ * classes: the table is checked while compiling and turned into a dense
+ * [state][event] array, so handling an event is one lookup. The actions
+ * object gets non virtual enter/exit calls the compiler can inline.
+ *
+ *   constexpr auto kTable = makeTransitionTable<AppState, AppEvent>(
+ *       AppState::UNINITIALIZED, {AppState::TERMINATED},
+ *       {{AppState::UNINITIALIZED, AppEvent::INIT_REQUEST, AppState::INITIALIZING},
+ *        ...
+ *        completion(AppState::TERMINATING, AppState::TERMINATED)});
+ *   TableStateMachine<kTable, MyActions> machine(actions);
+ *
+ * State and event enums need a kEnumCount specialization (see ApplicationTransitions.hpp).
+ */
+
+// Number of enumerators of a dense enum starting at 0, specialized next to the enum
+template <typename Enum>
+inline constexpr std::size_t kEnumCount = 0;
+
+template <typename StateEnum>
+struct Completion
+{
+    StateEnum from;
+    StateEnum to;
+};
+
+// Taken as soon as 'from' is entered, without waiting for an event
+template <typename StateEnum>
+constexpr Completion<StateEnum> completion(StateEnum from, StateEnum to)
+{
+    return {from, to};
+}
+
+template <typename StateEnum, typename EventEnum>
+struct Transition
+{
+    StateEnum from{};
+    EventEnum event{};
+    StateEnum to{};
+    bool completion = false; // event unused
+
+    constexpr Transition() = default;
+    constexpr Transition(StateEnum source, EventEnum trigger, StateEnum target)
+        : from(source), event(trigger), to(target)
+    {
+    }
+    constexpr Transition(Completion<StateEnum> next) : from(next.from), to(next.to), completion(true) {}
+};
+
+inline constexpr std::uint8_t kNoTransition = 0xFF;
+
+/*---Transitions of a state machine, structural so it can be a template argument---*/
+template <typename StateEnum, typename EventEnum, std::size_t N, std::size_t F>
+struct TransitionTable
+{
+    using State = StateEnum;
+    using Event = EventEnum;
+    static constexpr std::size_t kStates = kEnumCount<StateEnum>;
+    static constexpr std::size_t kEvents = kEnumCount<EventEnum>;
+
+    StateEnum initial;
+    std::array<StateEnum, F> finals; // may be left without a transition out
+    std::array<Transition<StateEnum, EventEnum>, N> transitions;
+
+    static constexpr std::size_t index(StateEnum state) { return static_cast<std::size_t>(state); }
+    static constexpr std::size_t index(EventEnum event) { return static_cast<std::size_t>(event); }
+
+    constexpr bool inRange() const
+    {
+        bool valid = index(initial) < kStates;
+        for (const auto &transition : transitions)
+        {
+            valid = valid && index(transition.from) < kStates && index(transition.to) < kStates &&
+                    (transition.completion || index(transition.event) < kEvents);
+        }
+        for (StateEnum state : finals)
+        {
+            valid = valid && index(state) < kStates;
+        }
+        return valid;
+    }
+
+    // At most one target per state and event, and no state both waits for events and moves on by itself
+    constexpr bool unambiguous() const
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = i + 1; j < N; ++j)
+            {
+                const auto &a = transitions[i];
+                const auto &b = transitions[j];
+                if (a.from == b.from && (a.completion || b.completion || a.event == b.event))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr std::array<bool, kStates> reached() const
+    {
+        std::array<bool, kStates> seen{};
+        seen[index(initial)] = true;
+        for (bool grew = true; grew;)
+        {
+            grew = false;
+            for (const auto &transition : transitions)
+            {
+                if (seen[index(transition.from)] && !seen[index(transition.to)])
+                {
+                    seen[index(transition.to)] = true;
+                    grew = true;
+                }
+            }
+        }
+        return seen;
+    }
+
+    constexpr bool allReachable() const
+    {
+        for (bool seen : reached())
+        {
+            if (!seen)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every state but the finals handles some event or completes, none is a dead end
+    constexpr bool noDeadEnds() const
+    {
+        for (std::size_t state = 0; state < kStates; ++state)
+        {
+            bool leaves = false;
+            for (const auto &transition : transitions)
+            {
+                leaves = leaves || index(transition.from) == state;
+            }
+            for (StateEnum end : finals)
+            {
+                leaves = leaves || index(end) == state;
+            }
+            if (!leaves)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Following completion transitions from any state ends in a state that waits for an event, not in a loop
+    constexpr bool completionsTerminate() const
+    {
+        const auto next = completions();
+        for (std::size_t state = 0; state < kStates; ++state)
+        {
+            std::size_t at = state;
+            for (std::size_t steps = 0; next[at] != kNoTransition; ++steps)
+            {
+                if (steps == kStates)
+                {
+                    return false;
+                }
+                at = next[at];
+            }
+        }
+        return true;
+    }
+
+    constexpr std::array<std::array<std::uint8_t, kEvents>, kStates> dense() const
+    {
+        std::array<std::array<std::uint8_t, kEvents>, kStates> next{};
+        for (auto &row : next)
+        {
+            row.fill(kNoTransition);
+        }
+        for (const auto &transition : transitions)
+        {
+            if (!transition.completion)
+            {
+                next[index(transition.from)][index(transition.event)] = static_cast<std::uint8_t>(transition.to);
+            }
+        }
+        return next;
+    }
+
+    constexpr std::array<std::uint8_t, kStates> completions() const
+    {
+        std::array<std::uint8_t, kStates> next{};
+        next.fill(kNoTransition);
+        for (const auto &transition : transitions)
+        {
+            if (transition.completion)
+            {
+                next[index(transition.from)] = static_cast<std::uint8_t>(transition.to);
+            }
+        }
+        return next;
+    }
+};
+
+template <typename StateEnum, typename EventEnum, std::size_t N, std::size_t F>
+constexpr TransitionTable<StateEnum, EventEnum, N, F>
+makeTransitionTable(StateEnum initial, const StateEnum (&finals)[F],
+                    const Transition<StateEnum, EventEnum> (&transitions)[N])
+{
+    TransitionTable<StateEnum, EventEnum, N, F> table{initial, {}, {}};
+    for (std::size_t i = 0; i < F; ++i)
+    {
+        table.finals[i] = finals[i];
+    }
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        table.transitions[i] = transitions[i];
+    }
+    return table;
+}
+
+/*---Runs a TransitionTable; Actions may define onEnter(State) and onExit(State), both optional---*/
+template <auto Table, typename Actions>
+class TableStateMachine
+{
+public:
+    using StateEnum = typename decltype(Table)::State;
+    using EventEnum = typename decltype(Table)::Event;
+
+    static_assert(decltype(Table)::kStates > 0 && decltype(Table)::kEvents > 0,
+                  "specialize kEnumCount for the state and event enums");
+    static_assert(decltype(Table)::kStates < kNoTransition, "too many states for a dense table");
+    static_assert(Table.inRange(), "transition table uses a state or event beyond kEnumCount");
+    static_assert(Table.unambiguous(), "transition table has two transitions for one state and event");
+    static_assert(Table.allReachable(), "transition table has a state unreachable from the initial state");
+    static_assert(Table.noDeadEnds(), "transition table has a non final state without a transition out");
+    static_assert(Table.completionsTerminate(), "transition table has a cycle of completion transitions");
+
+    explicit TableStateMachine(Actions &actions) : actions_(actions), current_(Table.initial) {}
+
+    // Enters the initial state, taking its completion transitions
+    void start()
+    {
+        enter(Table.initial);
+    }
+
+    // Takes the event's transition from the current state; false if the state does not handle it
+    bool handleEvent(EventEnum event)
+    {
+        const std::uint8_t next = kNext[index(current_)][static_cast<std::size_t>(event)];
+        if (next == kNoTransition)
+        {
+            return false;
+        }
+        exit(current_);
+        enter(static_cast<StateEnum>(next));
+        return true;
+    }
+
+    StateEnum getCurrentState() const
+    {
+        return current_;
+    }
+
+private:
+    static constexpr auto kNext = Table.dense();
+    static constexpr auto kCompletion = Table.completions();
+
+    static constexpr std::size_t index(StateEnum state)
+    {
+        return static_cast<std::size_t>(state);
+    }
+
+    // A loop, not recursion: chains of completion transitions cannot grow the stack
+    void enter(StateEnum state)
+    {
+        for (;;)
+        {
+            current_ = state;
+            if constexpr (requires(Actions &a) { a.onEnter(state); })
+            {
+                actions_.onEnter(state);
+            }
+            const std::uint8_t next = kCompletion[index(state)];
+            if (next == kNoTransition)
+            {
+                return;
+            }
+            exit(state);
+            state = static_cast<StateEnum>(next);
+        }
+    }
+
+    void exit(StateEnum state)
+    {
+        if constexpr (requires(Actions &a) { a.onExit(state); })
+        {
+            actions_.onExit(state);
+        }
+    }
+
+    Actions &actions_;
+    StateEnum current_;
+};
+
+#endif // COMMON_FRAMEWORK_TABLE_STATE_MACHINE_HPP
@@ -0,0 +1,145 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TransitionTrace.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+
+#include <unistd.h>
+
+namespace
+{
+std::string nameOf(TransitionTrace::NameOf name, int value)
+{
+    return (name != nullptr) ? name(value) : std::to_string(value);
+}
+
+void writeSlice(std::ostream &out, bool &first, const std::string &name, const char *category, std::int64_t beginNs,
+                std::int64_t endNs, std::size_t track, const std::string &event)
+{
+    // Microseconds with ns precision, the unit of the format
+    out << (first ? "\n" : ",\n") << "{\"name\":\"" << name << "\",\"cat\":\"" << category
+        << "\",\"ph\":\"X\",\"ts\":" << std::fixed << std::setprecision(3) << static_cast<double>(beginNs) / 1000.0
+        << ",\"dur\":" << static_cast<double>(std::max<std::int64_t>(endNs - beginNs, 0)) / 1000.0
+        << ",\"pid\":" << getpid() << ",\"tid\":" << track;
+    if (!event.empty())
+    {
+        out << ",\"args\":{\"event\":\"" << event << "\"}";
+    }
+    out << '}';
+    first = false;
+}
+
+void writeTrackName(std::ostream &out, bool &first, std::size_t track, const std::string &name)
+{
+    out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << getpid()
+        << ",\"tid\":" << track << ",\"args\":{\"name\":\"" << name << "\"}}";
+    first = false;
+}
+} // namespace
+
+TransitionTrace &TransitionTrace::instance()
+{
+    static TransitionTrace trace;
+    return trace;
+}
+
+void TransitionTrace::record(const TransitionRecord &transition)
+{
+    const std::uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index % kCapacity];
+
+    slot.state.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = transition;
+    slot.state.store(2 * index + 2, std::memory_order_release);
+}
+
+std::vector<TransitionRecord> TransitionTrace::snapshot() const
+{
+    const std::uint64_t end = next_.load(std::memory_order_acquire);
+    const std::uint64_t begin = (end > kCapacity) ? end - kCapacity : 0;
+
+    std::vector<TransitionRecord> records;
+    records.reserve(end - begin);
+    for (std::uint64_t index = begin; index < end; ++index)
+    {
+        const Slot &slot = slots_[index % kCapacity];
+        if (slot.state.load(std::memory_order_acquire) != 2 * index + 2)
+        {
+            continue; // still being written, or already overwritten
+        }
+        TransitionRecord copy = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.state.load(std::memory_order_relaxed) == 2 * index + 2)
+        {
+            records.push_back(copy);
+        }
+    }
+    return records;
+}
+
+void TransitionTrace::writeChromeTrace(std::ostream &out, NameOf stateName, NameOf eventName) const
+{
+    std::vector<TransitionRecord> records = snapshot();
+
+    // A transition made from within enter() is recorded before the one around it; order by entry
+    std::stable_sort(records.begin(), records.end(),
+                     [](const TransitionRecord &a, const TransitionRecord &b) { return a.exitedNs < b.exitedNs; });
+
+    std::map<const void *, std::size_t> machines;
+    bool first = true;
+    const std::ios::fmtflags flags = out.flags();
+    const std::streamsize precision = out.precision();
+    out << "{\"traceEvents\":[";
+    for (const TransitionRecord &record : records)
+    {
+        if (machines.emplace(record.machine, machines.size()).second)
+        {
+            const std::size_t machine = machines.size() - 1;
+            writeTrackName(out, first, 2 * machine + 1, "state machine " + std::to_string(machine) + " states");
+            writeTrackName(out, first, 2 * machine + 2, "state machine " + std::to_string(machine) + " transitions");
+        }
+    }
+
+    const std::int64_t endNs = now();
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        const TransitionRecord &record = records[i];
+        const std::size_t machine = machines[record.machine];
+        const std::string event = (record.event == kNoTraceEvent) ? "" : nameOf(eventName, record.event);
+
+        // In the state from being entered until the next transition of the machine exits it
+        std::int64_t leftNs = endNs;
+        for (std::size_t j = i + 1; j < records.size(); ++j)
+        {
+            if (records[j].machine == record.machine)
+            {
+                leftNs = records[j].exitedNs;
+                break;
+            }
+        }
+        writeSlice(out, first, nameOf(stateName, record.to), "state", record.exitedNs, leftNs, 2 * machine + 1, event);
+        writeSlice(out, first, "exit " + nameOf(stateName, record.from), "transition", record.startNs, record.exitedNs,
+                   2 * machine + 2, event);
+        writeSlice(out, first, "enter " + nameOf(stateName, record.to), "transition", record.exitedNs,
+                   record.enteredNs, 2 * machine + 2, event);
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n" << std::flush;
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,92 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef COMMON_FRAMEWORK_TRANSITION_TRACE_HPP
+#define COMMON_FRAMEWORK_TRANSITION_TRACE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Transition tracing of state machines, e.g. -DSTATE_MACHINE_TRACE=1 (the CMake option of the same name).
+// When 0 the hooks in StateMachine are discarded at compile time.
+#ifndef STATE_MACHINE_TRACE
+#define STATE_MACHINE_TRACE 0
+#endif
+
+inline constexpr bool kStateMachineTrace = STATE_MACHINE_TRACE != 0;
+inline constexpr int kNoTraceEvent = -1; // transition not caused by an event
+
+// One transition: exit of 'from' in [startNs, exitedNs), enter of 'to' in [exitedNs, enteredNs)
+struct TransitionRecord
+{
+    const void *machine = nullptr;
+    int from = 0;
+    int to = 0;
+    int event = kNoTraceEvent;
+    std::int64_t startNs = 0;
+    std::int64_t exitedNs = 0;
+    std::int64_t enteredNs = 0;
+};
+
+/*
+ * Process wide ring of the latest transitions. Recording claims a slot with
+ * one fetch_add and marks it complete through the slot's sequence word, like
+ * ShmRing; the oldest records are overwritten, nothing ever waits.
+ */
+class TransitionTrace
+{
+public:
+    static constexpr std::size_t kCapacity = 4096;
+
+    using NameOf = std::string (*)(int value);
+
+    static TransitionTrace &instance();
+
+    static std::int64_t now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    void record(const TransitionRecord &transition);
+
+    // The records still intact, oldest first
+    std::vector<TransitionRecord> snapshot() const;
+
+    // Chrome trace event JSON (chrome://tracing, Perfetto): per machine one track with the time
+    // spent in each state and one with the exit and enter calls. Names default to the numbers.
+    void writeChromeTrace(std::ostream &out, NameOf stateName = nullptr, NameOf eventName = nullptr) const;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> state{0}; // 2 * index + 1 while written, 2 * index + 2 once complete
+        TransitionRecord record;
+    };
+
+    TransitionTrace() = default;
+
+    std::array<Slot, kCapacity> slots_{};
+    std::atomic<std::uint64_t> next_{0};
+};
+
+#endif // COMMON_FRAMEWORK_TRANSITION_TRACE_HPP
@@ -0,0 +1,180 @@
+/*Copyright 2025 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "SignalBus.hpp"
+
+/*
+ * Brake path latency under a low priority flood.
+ *
+ * A brake signal is published every millisecond and handled on the pool; its
+ * latency is publish to handler entry. It is measured alone, then while
+ * another thread floods a telemetry topic whose handler takes ~20 us. The bus's
+ * own counters are printed at the end.
+ *
+ * Usage: signal_latency [--no-lanes] [--rt <priority>] [--cpu <n>]
+ *   --no-lanes   brake and telemetry share one lane (the behaviour without priorities)
+ *   --rt         SCHED_FIFO priority of the critical lane's thread
+ *   --cpu        pins the critical lane's thread
+ */
+
+#define LATENCY_BRAKE_FIELDS(FIELD) FIELD(std::int64_t, sent_ns)
+SIGNAL_WIRE_STRUCT(LatencyBrake, 1, LATENCY_BRAKE_FIELDS);
+
+#define LATENCY_TELEMETRY_FIELDS(FIELD) FIELD(std::int64_t, sequence)
+SIGNAL_WIRE_STRUCT(LatencyTelemetry, 1, LATENCY_TELEMETRY_FIELDS);
+
+namespace
+{
+constexpr int kSamples = 2000;
+constexpr auto kBrakePeriod = std::chrono::milliseconds(1);
+constexpr auto kTelemetryWork = std::chrono::microseconds(20);
+
+std::int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+struct Probe
+{
+    std::vector<std::int64_t> latencies;
+    std::atomic<int> received{0};
+    std::atomic<long> telemetry{0};
+
+    void onBrake(const LatencyBrake &signal)
+    {
+        latencies.push_back(nowNs() - signal.sent_ns);
+        received.fetch_add(1, std::memory_order_release);
+    }
+
+    void onTelemetry(const LatencyTelemetry &)
+    {
+        auto until = std::chrono::steady_clock::now() + kTelemetryWork;
+        while (std::chrono::steady_clock::now() < until)
+        {
+        }
+        telemetry.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+void report(const char *phase, std::vector<std::int64_t> latencies, long telemetry)
+{
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&](double q) { return latencies[static_cast<std::size_t>(q * (latencies.size() - 1))] / 1000.0; };
+
+    std::cout << phase << ": p50 " << at(0.50) << " us, p99 " << at(0.99) << " us, max " << latencies.back() / 1000.0
+              << " us (" << latencies.size() << " samples, " << telemetry << " telemetry handled)" << std::endl;
+}
+
+void measure(const char *phase, Probe &probe, Channel<LatencyBrake> brake)
+{
+    probe.latencies.clear();
+    probe.latencies.reserve(kSamples);
+    probe.received.store(0);
+    long telemetryBefore = probe.telemetry.load();
+
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < kSamples; ++i)
+    {
+        next += kBrakePeriod;
+        std::this_thread::sleep_until(next);
+        SignalBus::getInstance().publish(brake, LatencyBrake{nowNs()});
+
+        // One brake sample in flight at a time, latencies is not shared
+        while (probe.received.load(std::memory_order_acquire) <= i)
+        {
+            std::this_thread::yield();
+        }
+    }
+    report(phase, probe.latencies, probe.telemetry.load() - telemetryBefore);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    bool lanes = true;
+    LaneOptions critical;
+    critical.threads = 1;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--no-lanes") == 0)
+        {
+            lanes = false;
+        }
+        else if (std::strcmp(argv[i], "--rt") == 0 && i + 1 < argc)
+        {
+            critical.realtimePriority = std::atoi(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--cpu") == 0 && i + 1 < argc)
+        {
+            critical.cpu = std::atoi(argv[++i]);
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--no-lanes] [--rt <priority>] [--cpu <n>]" << std::endl;
+            return 1;
+        }
+    }
+
+    SignalBus &bus = SignalBus::getInstance();
+    auto brake = signalChannel<LatencyBrake, "LatencyBrake">();
+    auto telemetry = signalChannel<LatencyTelemetry, "LatencyTelemetry">();
+
+    bus.setWorkerPoolSize(1);
+    if (lanes)
+    {
+        bus.configureLane(SignalPriority::Critical, critical);
+        bus.setPriority(brake.id, SignalPriority::Critical);
+        bus.setPriority(telemetry.id, SignalPriority::Low);
+    }
+
+    Probe probe;
+    bus.subscribe<&Probe::onBrake>(brake, &probe, SubscribeOptions{DeliveryMode::Pool, 16, OverflowPolicy::Block});
+    // The telemetry handler's ~20 us exceeds its budget on purpose, it shows up as SLOW below
+    bus.subscribe<&Probe::onTelemetry>(
+        telemetry, &probe,
+        SubscribeOptions{DeliveryMode::Pool, 256, OverflowPolicy::DropOldest, std::chrono::microseconds(10)});
+
+    measure("idle   ", probe, brake);
+
+    std::atomic<bool> flooding{true};
+    std::thread flood(
+        [&]
+        {
+            std::int64_t sequence = 0;
+            while (flooding.load(std::memory_order_relaxed))
+            {
+                bus.publish(telemetry, LatencyTelemetry{sequence++});
+            }
+        });
+    measure("flooded", probe, brake);
+    flooding.store(false);
+    flood.join();
+
+    bus.metrics().print(std::cout);
+    bus.unsubscribe(&probe);
+    return 0;
+}
@@ -16,25 +16,26 @@
 #ifndef APPLICATION_CUSTOM_SIGNALS_HPP
 #define APPLICATION_CUSTOM_SIGNALS_HPP
 
-#include <string>
-#include "../../common-framework/signals/ISignal.hpp"
+#include <cstdint>
+
+#include "../../common-framework/signals/WireSchema.hpp"
+
+// Signal schemas: each field list generates a fixed layout wire struct (see WireSchema.hpp).
+// Bump the version whenever a field list changes.
 
 // A signal representing vehicle speed data
-struct SpeedSignal : public ISignal
-{
-    int speed_kmph;
-};
+#define SPEED_SIGNAL_FIELDS(FIELD) \
+    FIELD(std::int32_t, speed_kmph)
+SIGNAL_WIRE_STRUCT(SpeedSignal, 1, SPEED_SIGNAL_FIELDS);
 
 // A signal to request brake actuation
-struct BrakeRequestSignal : public ISignal
-{
-    double brake_pedal_position; // 0.0 to 1.0
-};
+#define BRAKE_REQUEST_SIGNAL_FIELDS(FIELD) \
+    FIELD(double, brake_pedal_position) /* 0.0 to 1.0 */
+SIGNAL_WIRE_STRUCT(BrakeRequestSignal, 1, BRAKE_REQUEST_SIGNAL_FIELDS);
 
 // A signal indicating current brake pressure
-struct BrakePressureSignal : public ISignal
-{
-    double current_pressure_psi;
-};
+#define BRAKE_PRESSURE_SIGNAL_FIELDS(FIELD) \
+    FIELD(double, current_pressure_psi)
+SIGNAL_WIRE_STRUCT(BrakePressureSignal, 1, BRAKE_PRESSURE_SIGNAL_FIELDS);
 
 #endif // APPLICATION_CUSTOM_SIGNALS_HPP
\ No newline at end of file
@@ -20,9 +20,23 @@ VehicleControlApp::VehicleControlApp() : Application("VehicleControlApp")
 {
     std::cout << appName_ << ": Specific application constructor called." << std::endl;
 
-    // Subscribe to relevant signals
-    subscribeToSignal("SpeedSignal", this, &VehicleControlApp::handleSpeedSignal);
-    subscribeToSignal("BrakeRequestSignal", this, &VehicleControlApp::handleBrakeRequestSignal);
+    // The brake path runs in the critical lane, ahead of everything else on the bus
+    signalBus_.setPriority(signalChannel<BrakeRequestSignal, "BrakeRequestSignal">().id, SignalPriority::Critical);
+    signalBus_.setPriority(signalChannel<BrakePressureSignal, "BrakePressureSignal">().id, SignalPriority::Critical);
+
+    // After a restart the last speed is replayed at once instead of waiting for the next sample
+    signalBus_.setHistory(signalChannel<SpeedSignal, "SpeedSignal">(), 1);
+
+    // Subscribe to relevant signals. Speed is handled on the application's run loop and only
+    // the latest sample matters; brake requests are handled inline, without queueing delay.
+    subscribeToSignal<&VehicleControlApp::handleSpeedSignal>(
+        signalChannel<SpeedSignal, "SpeedSignal">(), this,
+        SubscribeOptions{DeliveryMode::Polled, 4, OverflowPolicy::Coalesce});
+
+    // The run loop sleeps between brake pressure reports instead of ticking every 10 ms
+    setExecutePeriod(std::chrono::seconds(2));
+    subscribeToSignal<&VehicleControlApp::handleBrakeRequestSignal>(
+        signalChannel<BrakeRequestSignal, "BrakeRequestSignal">(), this);
 }
 
 void VehicleControlApp::onInitialize()
@@ -35,16 +49,12 @@ void VehicleControlApp::onInitialize()
 
 void VehicleControlApp::onExecute()
 {
-    // This method is called repeatedly when the application is in the RUNNING state.
+    // This method is called every execute period (2 seconds) while the application is RUNNING.
     // Example: Publish current brake pressure periodically
-    static int counter = 0;
-    if (++counter % 200 == 0)
-    { // Publish every 200 ticks (approx 2 seconds with 10ms sleep)
-        BrakePressureSignal currentPressure;
-        currentPressure.current_pressure_psi = 100.0; // Dummy value
-        publishSignal("BrakePressureSignal", currentPressure);
-        std::cout << appName_ << ": Published BrakePressureSignal." << std::endl;
-    }
+    BrakePressureSignal currentPressure;
+    currentPressure.current_pressure_psi = 100.0; // Dummy value
+    publishSignal(signalChannel<BrakePressureSignal, "BrakePressureSignal">(), currentPressure);
+    std::cout << appName_ << ": Published BrakePressureSignal." << std::endl;
 }
 
 void VehicleControlApp::onTerminate()
@@ -17,6 +17,7 @@
 #include <memory>
 #include <thread>
 #include <chrono>
+#include <string>
 
 #include "VehicleControlApp.hpp"
 #include "../../common-framework/signals/SignalBus.hpp" // For IpcBridge access through SignalBus
@@ -26,24 +27,29 @@ int main(int argc, char *argv[])
 {
     std::cout << "--- VehicleControlApp Executable Started ---" << std::endl;
 
+    // --state-trace <file>: startup and shutdown timeline, needs a STATE_MACHINE_TRACE build
+    const std::string stateTracePath = (argc > 2 && std::string(argv[1]) == "--state-trace") ? argv[2] : "";
+
     VehicleControlApp app;
 
     // simulating publish in the same process for demonstration.
     std::thread simulated_publisher_thread([]()
                                            {
+        const auto speedChannel = signalChannel<SpeedSignal, "SpeedSignal">();
+        const auto brakeRequestChannel = signalChannel<BrakeRequestSignal, "BrakeRequestSignal">();
         std::this_thread::sleep_for(std::chrono::seconds(2)); // Wait for app to initialize
         for (int i = 0; i < 5; ++i) {
             SpeedSignal speed;
             speed.speed_kmph = 50 + i * 10;
             std::cout << "[SIMULATED IPC]: Sending SpeedSignal: " << speed.speed_kmph << " kmph" << std::endl;
             // Directly use IpcBridge to simulate an external process sending a signal
-            IpcBridge::getInstance().receiveAndDispatch("SpeedSignal", speed);
+            IpcBridge::getInstance().receiveAndDispatch(speedChannel, speed);
             std::this_thread::sleep_for(std::chrono::seconds(3));
 
             BrakeRequestSignal brakeReq;
             brakeReq.brake_pedal_position = (double)i / 5.0;
             std::cout << "[SIMULATED IPC]: Sending BrakeRequestSignal: " << brakeReq.brake_pedal_position << std::endl;
-            IpcBridge::getInstance().receiveAndDispatch("BrakeRequestSignal", brakeReq);
+            IpcBridge::getInstance().receiveAndDispatch(brakeRequestChannel, brakeReq);
             std::this_thread::sleep_for(std::chrono::seconds(3));
         } });
 
@@ -63,6 +69,10 @@ int main(int argc, char *argv[])
 
     // 3. Terminate the application
     app.terminate();
+    if (!stateTracePath.empty())
+    {
+        app.writeStateTrace(stateTracePath);
+    }
 
     if (simulated_publisher_thread.joinable())
     {
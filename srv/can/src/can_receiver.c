@@ -14,12 +14,17 @@
  * limitations under the License.
  */
 
+#define _GNU_SOURCE /*---recvmmsg()---*/
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
 
+#define LOG_MODULE LOG_MODULE_CAN
+#include "logger.h"
+
 #include "can_receiver.h"
 
 int initialize_can_socket(const char *ifname)
@@ -58,6 +63,13 @@ int initialize_can_socket(const char *ifname)
         return -1;
     }
 
+    // Ask the kernel to attach its receive queue drop counter to every frame
+    int enable = 1;
+    if (setsockopt(sock_, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)) < 0)
+    {
+        perror("setsockopt SO_RXQ_OVFL failed, socket drops will not be reported");
+    }
+
     printf("Successfully initialized CAN socket on interface: %s\n", ifname);
     return sock_;
 }
@@ -72,29 +84,31 @@ int receive_can_frames(int sock_, struct can_frame *frame)
 
         if (sock_ < 0)
         {
-            fprintf(stderr, "Error: Invalid socket descriptor passed to receive_can_frames.\n");
+            DEBUG_LOG_RATELIMIT(DEBUG_ERROR, 1, 5, "Invalid socket descriptor passed to receive_can_frames.");
             return E_NOT_OK;
         }
 
-        printf("Listening for CAN frames...\n");
+        // Called once per frame, announce only the first call
+        DEBUG_LOG_SAMPLED(DEBUG_INFO, 1, 0, "Listening for CAN frames...");
         nbytes = read(sock_, frame, sizeof(struct can_frame));
 
         if (nbytes < 0)
         {
-            if (errno == EINTR)
+            if (errno != EINTR)
             {
-                // Interrupted system call, try again
+                // Interrupted system call is retried by the caller, anything else may repeat at bus rate
+                DEBUG_LOG_RATELIMIT(DEBUG_ERROR, 1, 5, "Read error on CAN socket: %s", strerror(errno));
             }
-            perror("Read error on CAN socket");
         }
         else if (nbytes == 0)
         {
             // End of file (shouldn't happen with sockets unless closed by peer)
-            fprintf(stderr, "Read returned 0 bytes (socket possibly closed by peer).\n");
+            DEBUG_LOG_RATELIMIT(DEBUG_ERROR, 1, 5, "Read returned 0 bytes (socket possibly closed by peer).");
         }
         else if (nbytes < sizeof(struct can_frame))
         {
-            fprintf(stderr, "Partial CAN frame received: %d bytes. Expected %lu.\n", nbytes, sizeof(struct can_frame));
+            DEBUG_LOG_RATELIMIT(DEBUG_WARNING, 1, 5, "Partial CAN frame received: %d bytes. Expected %zu.", nbytes,
+                                sizeof(struct can_frame));
         }
         else
         {
@@ -103,4 +117,207 @@ int receive_can_frames(int sock_, struct can_frame *frame)
     }
 
     return ret;
-}
\ No newline at end of file
+}
+
+static int get_rcvbuf_size(int sock_)
+{
+    int size = 0;
+    socklen_t len = sizeof(size);
+
+    if (getsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &size, &len) < 0)
+    {
+        return -1;
+    }
+    return size;
+}
+
+/*---Doubles the receive buffer, preferring SO_RCVBUFFORCE so rmem_max does not cap us when privileged---*/
+static void grow_rcvbuf(int sock_, struct can_rx_stats *stats)
+{
+    // The kernel doubles the requested value and reports the doubled size back
+    int request = stats->rcvbuf_bytes;
+
+    if (request <= 0 || stats->rcvbuf_capped || stats->rcvbuf_bytes >= CAN_RX_RCVBUF_MAX)
+    {
+        return;
+    }
+    if (request > CAN_RX_RCVBUF_MAX / 2)
+    {
+        request = CAN_RX_RCVBUF_MAX / 2;
+    }
+
+    if (setsockopt(sock_, SOL_SOCKET, SO_RCVBUFFORCE, &request, sizeof(request)) < 0)
+    {
+        // Not CAP_NET_ADMIN, fall back to the unprivileged option (capped by net.core.rmem_max)
+        if (setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &request, sizeof(request)) < 0)
+        {
+            stats->rcvbuf_capped = 1;
+            return;
+        }
+    }
+
+    int size = get_rcvbuf_size(sock_);
+    if (size > stats->rcvbuf_bytes)
+    {
+        fprintf(stderr, "CAN socket receive buffer grown from %d to %d bytes.\n", stats->rcvbuf_bytes, size);
+        stats->rcvbuf_bytes = size;
+        stats->rcvbuf_resizes++;
+    }
+    else
+    {
+        // Capped by the system limit, keep reporting the real size but do not retry on every batch
+        stats->rcvbuf_capped = 1;
+        if (size > 0)
+        {
+            stats->rcvbuf_bytes = size;
+        }
+    }
+}
+
+static void log_drops_rate_limited(struct can_rx_stats *stats)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if (stats->last_drop_log.tv_sec != 0 &&
+        (now.tv_sec - stats->last_drop_log.tv_sec) < CAN_RX_DROP_LOG_INTERVAL_SEC)
+    {
+        return;
+    }
+
+    fprintf(stderr, "CAN socket dropped %llu frames (total %llu, rcvbuf %d bytes%s).\n",
+            (unsigned long long)stats->drops_since_log, (unsigned long long)stats->frames_dropped,
+            stats->rcvbuf_bytes, stats->rcvbuf_capped ? ", at system limit" : "");
+    stats->drops_since_log = 0;
+    stats->last_drop_log = now;
+}
+
+int init_can_rx_stats(int sock_, struct can_rx_stats *stats)
+{
+    if (sock_ < 0 || NULL == stats)
+    {
+        return E_NOT_OK;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->rcvbuf_bytes = get_rcvbuf_size(sock_);
+    return E_OK;
+}
+
+int receive_can_frame_batch(int sock_, struct can_frame *frames, unsigned int max_frames, struct can_rx_stats *stats)
+{
+    struct mmsghdr msgs[CAN_RX_BATCH_MAX];
+    struct iovec iovs[CAN_RX_BATCH_MAX];
+    // The union gives each control buffer the alignment CMSG_FIRSTHDR expects
+    union
+    {
+        char buf[CMSG_SPACE(sizeof(uint32_t))];
+        struct cmsghdr align;
+    } ctrl[CAN_RX_BATCH_MAX];
+    int count;
+
+    if (sock_ < 0 || NULL == frames || NULL == stats || 0U == max_frames)
+    {
+        DEBUG_LOG_RATELIMIT(DEBUG_ERROR, 1, 5, "Invalid arguments passed to receive_can_frame_batch.");
+        return -1;
+    }
+    if (max_frames > CAN_RX_BATCH_MAX)
+    {
+        max_frames = CAN_RX_BATCH_MAX;
+    }
+
+    for (unsigned int i = 0; i < max_frames; ++i)
+    {
+        iovs[i].iov_base = &frames[i];
+        iovs[i].iov_len = sizeof(struct can_frame);
+        memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = ctrl[i].buf;
+        msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i].buf);
+    }
+
+    // Block for the first frame only, then drain what is already queued
+    count = recvmmsg(sock_, msgs, max_frames, MSG_WAITFORONE, NULL);
+    if (count < 0)
+    {
+        if (errno != EINTR)
+        {
+            DEBUG_LOG_RATELIMIT(DEBUG_ERROR, 1, 5, "recvmmsg error on CAN socket: %s", strerror(errno));
+        }
+        return -1;
+    }
+
+    // Compact out partial frames so frames[0..valid) are all complete
+    int valid = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (msgs[i].msg_len < sizeof(struct can_frame))
+        {
+            DEBUG_LOG_RATELIMIT(DEBUG_WARNING, 1, 5, "Partial CAN frame received: %u bytes. Expected %zu.",
+                                msgs[i].msg_len, sizeof(struct can_frame));
+            continue;
+        }
+        if (valid != i)
+        {
+            frames[valid] = frames[i];
+        }
+        valid++;
+    }
+
+    // The overflow counter is cumulative, the newest frame carries the latest value
+    uint64_t new_drops = 0;
+    if (count > 0)
+    {
+        struct msghdr *last = &msgs[count - 1].msg_hdr;
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(last); cmsg != NULL; cmsg = CMSG_NXTHDR(last, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+            {
+                uint32_t ovfl;
+                memcpy(&ovfl, CMSG_DATA(cmsg), sizeof(ovfl));
+                new_drops = (uint32_t)(ovfl - stats->last_ovfl_count);
+                stats->last_ovfl_count = ovfl;
+            }
+        }
+    }
+
+    stats->frames_received += (uint64_t)valid;
+    stats->batches++;
+    if ((uint32_t)count > stats->max_burst)
+    {
+        stats->max_burst = (uint32_t)count;
+    }
+
+    if (new_drops > 0U)
+    {
+        stats->frames_dropped += new_drops;
+        stats->drops_since_log += new_drops;
+    }
+    // Also flushes drops held back by the rate limit once the interval has passed
+    if (stats->drops_since_log > 0U)
+    {
+        log_drops_rate_limited(stats);
+    }
+
+    // A full batch means the queue was at least this deep, grow before it overflows (again)
+    if (new_drops > 0U || (unsigned int)count == max_frames)
+    {
+        grow_rcvbuf(sock_, stats);
+    }
+
+    return valid;
+}
+
+void report_can_rx_stats(const struct can_rx_stats *stats)
+{
+    if (NULL == stats)
+    {
+        return;
+    }
+
+    printf("CAN rx: total rx %llu drop %llu | batches %llu max burst %u | rcvbuf %d bytes, %u resizes%s\n",
+           (unsigned long long)stats->frames_received, (unsigned long long)stats->frames_dropped,
+           (unsigned long long)stats->batches, stats->max_burst, stats->rcvbuf_bytes, stats->rcvbuf_resizes,
+           stats->rcvbuf_capped ? ", at system limit" : "");
+}
@@ -17,6 +17,8 @@
 #ifndef CAN_UTILS_H
 #define CAN_UTILS_H
 
+#include <stdint.h>
+#include <time.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
@@ -25,6 +27,31 @@
 
 #include "osap_common.h"
 
+#define CAN_RX_BATCH_MAX 64U                 /*---max frames drained per receive_can_frame_batch() call---*/
+#define CAN_RX_RCVBUF_MAX (4 * 1024 * 1024)  /*---upper bound for adaptive SO_RCVBUF growth (bytes)---*/
+#define CAN_RX_DROP_LOG_INTERVAL_SEC 1       /*---min seconds between two socket drop log lines---*/
+
+/**
+ * @brief Receive path metrics for a CAN socket.
+ *
+ * Filled by receive_can_frame_batch(). frames_dropped is derived from the
+ * kernel SO_RXQ_OVFL counter, so it tells frames lost at the socket apart
+ * from latency introduced by our own processing.
+ */
+struct can_rx_stats
+{
+    uint64_t frames_received;        /* frames handed to the caller */
+    uint64_t frames_dropped;         /* frames dropped by the kernel receive queue */
+    uint64_t batches;                /* successful batch receive calls */
+    uint32_t max_burst;              /* largest number of frames seen in one batch */
+    uint32_t rcvbuf_resizes;         /* number of times SO_RCVBUF was grown */
+    int rcvbuf_bytes;                /* current effective receive buffer size */
+    int rcvbuf_capped;               /* non-zero once growth was refused by the system limit */
+    uint32_t last_ovfl_count;        /* last raw SO_RXQ_OVFL value seen */
+    uint64_t drops_since_log;        /* drops not yet reported by the rate-limited log */
+    struct timespec last_drop_log;   /* CLOCK_MONOTONIC time of the last drop log line */
+};
+
 /**
  * @brief Initializes a CAN socket and binds it to a specified interface.
  *
@@ -58,4 +85,42 @@ int initialize_can_socket(const char *ifname);
  */
 int receive_can_frames(int sock_, struct can_frame *frame);
 
+/**
+ * @brief Resets receive metrics and captures the socket's current SO_RCVBUF.
+ *
+ * Must be called once after initialize_can_socket() and before the first
+ * receive_can_frame_batch() call on the same socket.
+ *
+ * @param sock_ The file descriptor of the initialized CAN socket.
+ * @param stats The metrics block to initialize.
+ * @return E_OK on success, E_NOT_OK on invalid arguments.
+ */
+int init_can_rx_stats(int sock_, struct can_rx_stats *stats);
+
+/**
+ * @brief Receives up to max_frames CAN frames with a single recvmmsg() call.
+ *
+ * Blocks until at least one frame is available, then drains whatever is
+ * already queued without blocking again. The SO_RXQ_OVFL counter attached
+ * to the received frames is used to account kernel drops in stats. When the
+ * queue is seen overflowing or a batch fills completely, SO_RCVBUF is grown
+ * (via SO_RCVBUFFORCE when privileged) up to CAN_RX_RCVBUF_MAX. Drops are
+ * reported on stderr at most once per CAN_RX_DROP_LOG_INTERVAL_SEC; drops held
+ * back by that limit are flushed by the first call after the interval passed.
+ *
+ * @param sock_ The file descriptor of the initialized CAN socket.
+ * @param frames Caller provided array receiving the frames.
+ * @param max_frames Capacity of frames, clamped to CAN_RX_BATCH_MAX.
+ * @param stats Metrics block initialized with init_can_rx_stats().
+ * @return Number of frames received, or -1 on error.
+ */
+int receive_can_frame_batch(int sock_, struct can_frame *frames, unsigned int max_frames, struct can_rx_stats *stats);
+
+/**
+ * @brief Prints the cumulative receive metrics to stdout.
+ *
+ * @param stats Metrics block filled by receive_can_frame_batch().
+ */
+void report_can_rx_stats(const struct can_rx_stats *stats);
+
 #endif // CAN_UTILS_H
\ No newline at end of file
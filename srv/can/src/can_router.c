@@ -0,0 +1,544 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE /*---recvmmsg()/sendmmsg()---*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/epoll.h>
+
+#include "can_router.h"
+#include "extract_signal.h"
+
+#define NSEC_PER_SEC 1000000000ULL
+
+/*---Room for both SO_TIMESTAMPNS and SO_RXQ_OVFL on every received frame---*/
+#define CAN_ROUTER_CTRL_LEN (CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(uint32_t)))
+
+static uint64_t timespec_diff_ns(const struct timespec *later, const struct timespec *earlier)
+{
+    int64_t ns = (int64_t)(later->tv_sec - earlier->tv_sec) * (int64_t)NSEC_PER_SEC +
+                 (later->tv_nsec - earlier->tv_nsec);
+    return ns > 0 ? (uint64_t)ns : 0U;
+}
+
+static int find_or_add_iface(struct can_router *router, const char *ifname)
+{
+    for (unsigned int i = 0; i < router->num_ifaces; ++i)
+    {
+        if (strncmp(router->ifaces[i].name, ifname, IFNAMSIZ) == 0)
+        {
+            return (int)i;
+        }
+    }
+
+    if (router->num_ifaces >= CAN_ROUTER_MAX_IFACES)
+    {
+        fprintf(stderr, "CAN router: too many interfaces (max %u).\n", CAN_ROUTER_MAX_IFACES);
+        return -1;
+    }
+
+    struct can_router_iface *iface = &router->ifaces[router->num_ifaces];
+    strncpy(iface->name, ifname, IFNAMSIZ - 1);
+    iface->name[IFNAMSIZ - 1] = '\0';
+    iface->sock = initialize_can_socket(ifname);
+    if (iface->sock < 0)
+    {
+        return -1;
+    }
+    return (int)router->num_ifaces++;
+}
+
+/*---Only routed IDs are delivered to a source socket; destination-only sockets receive nothing---*/
+static int install_rx_filters(struct can_router *router, unsigned int iface_idx)
+{
+    struct can_filter filters[CAN_ROUTER_MAX_ROUTES];
+    unsigned int num_filters = 0;
+    int enable = 1;
+
+    for (unsigned int r = 0; r < router->num_routes; ++r)
+    {
+        if (router->route_src[r] == iface_idx)
+        {
+            filters[num_filters].can_id = router->routes[r].id;
+            filters[num_filters].can_mask = router->routes[r].mask;
+            num_filters++;
+        }
+    }
+
+    int sock_ = router->ifaces[iface_idx].sock;
+    if (setsockopt(sock_, SOL_CAN_RAW, CAN_RAW_FILTER, num_filters ? filters : NULL,
+                   num_filters * sizeof(struct can_filter)) < 0)
+    {
+        perror("setsockopt CAN_RAW_FILTER failed");
+        return E_NOT_OK;
+    }
+
+    if (num_filters == 0U)
+    {
+        return E_OK;
+    }
+
+    if (setsockopt(sock_, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) < 0)
+    {
+        perror("setsockopt SO_TIMESTAMPNS failed, forwarding latency will not be measured");
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.u32 = iface_idx;
+    if (epoll_ctl(router->epoll_fd, EPOLL_CTL_ADD, sock_, &ev) < 0)
+    {
+        perror("epoll_ctl failed");
+        return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+int can_router_init(struct can_router *router, const struct can_route *routes, unsigned int num_routes)
+{
+    if (NULL == router || NULL == routes || num_routes == 0U || num_routes > CAN_ROUTER_MAX_ROUTES)
+    {
+        fprintf(stderr, "Error: Invalid routing table passed to can_router_init.\n");
+        return E_NOT_OK;
+    }
+
+    memset(router, 0, sizeof(*router));
+    router->stats.latency_ns_min = UINT64_MAX;
+    router->epoll_fd = epoll_create1(0);
+    if (router->epoll_fd < 0)
+    {
+        perror("epoll_create1 failed");
+        return E_NOT_OK;
+    }
+
+    for (unsigned int r = 0; r < num_routes; ++r)
+    {
+        const struct SignalDefinition *rw_src = routes[r].rewrite_src;
+        const struct SignalDefinition *rw_dst = routes[r].rewrite_dst;
+        if (rw_src != NULL && rw_dst != NULL &&
+            (!signalFitsFrame(rw_src->start_bit, rw_src->length) || !signalFitsFrame(rw_dst->start_bit, rw_dst->length) ||
+             rw_dst->scale == 0.0))
+        {
+            fprintf(stderr, "Error: Route %u rewrites a signal that does not fit a CAN frame.\n", r);
+            can_router_close(router);
+            return E_NOT_OK;
+        }
+
+        /*---new_id has no flag bits and fits every frame format the route can match---*/
+        canid_t id_limit = ((routes[r].id & routes[r].mask & CAN_EFF_FLAG) != 0U) ? CAN_EFF_MASK : CAN_SFF_MASK;
+        if (routes[r].new_id != CAN_ROUTE_KEEP_ID && routes[r].new_id > id_limit)
+        {
+            fprintf(stderr, "Error: Route %u remaps to ID 0x%X, too wide for the frames it matches.\n", r,
+                    routes[r].new_id);
+            can_router_close(router);
+            return E_NOT_OK;
+        }
+
+        int src = find_or_add_iface(router, routes[r].src_ifname);
+        int dst = (src < 0) ? -1 : find_or_add_iface(router, routes[r].dst_ifname);
+        if (dst < 0)
+        {
+            can_router_close(router);
+            return E_NOT_OK;
+        }
+        router->routes[r] = routes[r];
+        router->route_src[r] = (uint8_t)src;
+        router->route_dst[r] = (uint8_t)dst;
+    }
+    router->num_routes = num_routes;
+
+    for (unsigned int i = 0; i < router->num_ifaces; ++i)
+    {
+        if (install_rx_filters(router, i) != E_OK)
+        {
+            can_router_close(router);
+            return E_NOT_OK;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &router->last_report_time);
+    return E_OK;
+}
+
+/*---Clamps a scaled destination value to what 'dst->length' bits can hold---*/
+static uint64_t saturate_raw(double scaled, const struct SignalDefinition *dst)
+{
+    if (isnan(scaled))
+    {
+        return 0U;
+    }
+    if (dst->is_signed)
+    {
+        double limit = ldexp(1.0, dst->length - 1);
+        int64_t max = INT64_MAX >> (64 - dst->length);
+        if (scaled >= limit)
+        {
+            return (uint64_t)max;
+        }
+        if (scaled < -limit)
+        {
+            return (uint64_t)(-max - 1);
+        }
+        return (uint64_t)(int64_t)scaled;
+    }
+    if (scaled <= 0.0)
+    {
+        return 0U;
+    }
+    if (scaled >= ldexp(1.0, dst->length))
+    {
+        return UINT64_MAX >> (64 - dst->length);
+    }
+    return (uint64_t)scaled;
+}
+
+static unsigned int signal_end_byte(const struct SignalDefinition *signal)
+{
+    return ((unsigned int)signal->start_bit + signal->length - 1U) / 8U;
+}
+
+/*---Decodes the signal with the source plan and re-encodes it with the destination plan---*/
+static void rewrite_signal(struct can_frame *out, const struct can_frame *in, const struct can_route *route)
+{
+    const struct SignalDefinition *src = route->rewrite_src;
+    const struct SignalDefinition *dst = route->rewrite_dst;
+    uint64_t raw = extractSignal(in->data, src->start_bit, src->length, src->is_big_endian);
+    uint64_t out_raw;
+
+    if (src->length == dst->length && src->scale == dst->scale && src->offset == dst->offset &&
+        src->is_signed == dst->is_signed)
+    {
+        // Same width and scaling, only the position changes
+        out_raw = raw;
+    }
+    else
+    {
+        double physical;
+        if (src->is_signed && src->length < 64 && (raw >> (src->length - 1)) & 1ULL)
+        {
+            physical = (double)(int64_t)(raw | ~((1ULL << src->length) - 1ULL));
+        }
+        else
+        {
+            physical = src->is_signed ? (double)(int64_t)raw : (double)raw;
+        }
+        physical = physical * src->scale + src->offset;
+        out_raw = saturate_raw(round((physical - dst->offset) / dst->scale), dst);
+    }
+
+    // The source field must not leak into the forwarded payload
+    insertSignal(out->data, src->start_bit, src->length, src->is_big_endian, 0U);
+    insertSignal(out->data, dst->start_bit, dst->length, dst->is_big_endian, out_raw);
+
+    // Drop trailing bytes only the source field used, and cover the whole destination field
+    unsigned int dlc = out->can_dlc > CAN_MAX_DLEN ? CAN_MAX_DLEN : out->can_dlc;
+    while (dlc > src->start_bit / 8U && dlc - 1U <= signal_end_byte(src) && out->data[dlc - 1U] == 0U)
+    {
+        dlc--;
+    }
+    if (dlc < signal_end_byte(dst) + 1U)
+    {
+        dlc = signal_end_byte(dst) + 1U;
+    }
+    out->can_dlc = (uint8_t)dlc;
+}
+
+static void flush_tx(struct can_router *router, struct can_router_iface *iface)
+{
+    struct mmsghdr msgs[CAN_RX_BATCH_MAX];
+    struct iovec iovs[CAN_RX_BATCH_MAX];
+    unsigned int sent = 0;
+
+    if (iface->tx_count == 0U)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < iface->tx_count; ++i)
+    {
+        iovs[i].iov_base = &iface->tx_frames[i];
+        iovs[i].iov_len = sizeof(struct can_frame);
+        memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    // Never block the forwarding loop on a saturated destination bus
+    while (sent < iface->tx_count)
+    {
+        int n = sendmmsg(iface->sock, &msgs[sent], iface->tx_count - sent, MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        sent += (unsigned int)n;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    for (unsigned int i = 0; i < sent; ++i)
+    {
+        if (iface->tx_rx_time[i].tv_sec == 0)
+        {
+            continue;
+        }
+        uint64_t latency = timespec_diff_ns(&now, &iface->tx_rx_time[i]);
+        router->stats.latency_ns_total += latency;
+        router->stats.latency_samples++;
+        if (latency < router->stats.latency_ns_min)
+        {
+            router->stats.latency_ns_min = latency;
+        }
+        if (latency > router->stats.latency_ns_max)
+        {
+            router->stats.latency_ns_max = latency;
+        }
+    }
+
+    router->stats.frames_forwarded += sent;
+    router->stats.tx_dropped += iface->tx_count - sent;
+    iface->tx_count = 0;
+}
+
+static int forward_from(struct can_router *router, unsigned int src_idx)
+{
+    struct can_router_iface *src = &router->ifaces[src_idx];
+    struct can_frame frames[CAN_RX_BATCH_MAX];
+    struct mmsghdr msgs[CAN_RX_BATCH_MAX];
+    struct iovec iovs[CAN_RX_BATCH_MAX];
+    union
+    {
+        char buf[CAN_ROUTER_CTRL_LEN];
+        struct cmsghdr align; // CMSG_FIRSTHDR needs cmsghdr alignment
+    } ctrl[CAN_RX_BATCH_MAX];
+    struct timespec rx_time[CAN_RX_BATCH_MAX];
+    uint64_t forwarded_before = router->stats.frames_forwarded;
+
+    for (unsigned int i = 0; i < CAN_RX_BATCH_MAX; ++i)
+    {
+        iovs[i].iov_base = &frames[i];
+        iovs[i].iov_len = sizeof(struct can_frame);
+        msgs[i].msg_hdr.msg_name = NULL;
+        msgs[i].msg_hdr.msg_namelen = 0;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_flags = 0;
+    }
+
+    for (;;)
+    {
+        for (unsigned int i = 0; i < CAN_RX_BATCH_MAX; ++i)
+        {
+            msgs[i].msg_hdr.msg_control = ctrl[i].buf;
+            msgs[i].msg_hdr.msg_controllen = sizeof(ctrl[i].buf);
+        }
+
+        int count = recvmmsg(src->sock, msgs, CAN_RX_BATCH_MAX, MSG_DONTWAIT, NULL);
+        if (count < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+            {
+                break;
+            }
+            perror("recvmmsg error on CAN router socket");
+            return -1;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            struct msghdr *hdr = &msgs[i].msg_hdr;
+            rx_time[i].tv_sec = 0;
+            rx_time[i].tv_nsec = 0;
+            for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(hdr, cmsg))
+            {
+                if (cmsg->cmsg_level != SOL_SOCKET)
+                {
+                    continue;
+                }
+                if (cmsg->cmsg_type == SO_TIMESTAMPNS)
+                {
+                    memcpy(&rx_time[i], CMSG_DATA(cmsg), sizeof(struct timespec));
+                }
+                else if (cmsg->cmsg_type == SO_RXQ_OVFL)
+                {
+                    uint32_t ovfl;
+                    memcpy(&ovfl, CMSG_DATA(cmsg), sizeof(ovfl));
+                    router->stats.rx_dropped += (uint32_t)(ovfl - src->last_ovfl_count);
+                    src->last_ovfl_count = ovfl;
+                }
+            }
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            const struct can_frame *in = &frames[i];
+            int routed = 0;
+
+            if (msgs[i].msg_len < sizeof(struct can_frame))
+            {
+                continue;
+            }
+            router->stats.frames_received++;
+
+            for (unsigned int r = 0; r < router->num_routes; ++r)
+            {
+                const struct can_route *route = &router->routes[r];
+                if (router->route_src[r] != src_idx || ((in->can_id ^ route->id) & route->mask) != 0U)
+                {
+                    continue;
+                }
+
+                struct can_router_iface *dst = &router->ifaces[router->route_dst[r]];
+                if (dst->tx_count == CAN_RX_BATCH_MAX)
+                {
+                    flush_tx(router, dst);
+                }
+
+                struct can_frame *out = &dst->tx_frames[dst->tx_count];
+                *out = *in;
+                if (route->new_id != CAN_ROUTE_KEEP_ID)
+                {
+                    out->can_id = (in->can_id & (CAN_EFF_FLAG | CAN_RTR_FLAG | CAN_ERR_FLAG)) | route->new_id;
+                }
+                if (route->rewrite_src != NULL && route->rewrite_dst != NULL)
+                {
+                    rewrite_signal(out, in, route);
+                }
+                dst->tx_rx_time[dst->tx_count] = rx_time[i];
+                dst->tx_count++;
+                routed = 1;
+            }
+
+            if (!routed)
+            {
+                router->stats.frames_unrouted++;
+            }
+        }
+
+        for (unsigned int d = 0; d < router->num_ifaces; ++d)
+        {
+            flush_tx(router, &router->ifaces[d]);
+        }
+
+        if (count < (int)CAN_RX_BATCH_MAX)
+        {
+            break; // Queue drained
+        }
+    }
+
+    return (int)(router->stats.frames_forwarded - forwarded_before);
+}
+
+int can_router_poll(struct can_router *router, int timeout_ms)
+{
+    struct epoll_event events[CAN_ROUTER_MAX_IFACES];
+    int forwarded = 0;
+
+    if (NULL == router || router->epoll_fd < 0)
+    {
+        return -1;
+    }
+
+    int n = epoll_wait(router->epoll_fd, events, CAN_ROUTER_MAX_IFACES, timeout_ms);
+    if (n < 0)
+    {
+        if (errno == EINTR)
+        {
+            return 0;
+        }
+        perror("epoll_wait failed");
+        return -1;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+        int ret = forward_from(router, events[i].data.u32);
+        if (ret < 0)
+        {
+            return -1;
+        }
+        forwarded += ret;
+    }
+    return forwarded;
+}
+
+void can_router_report(struct can_router *router)
+{
+    struct timespec now;
+    const struct can_router_stats *s = &router->stats;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (double)timespec_diff_ns(&now, &router->last_report_time) / (double)NSEC_PER_SEC;
+    if (elapsed <= 0.0)
+    {
+        return;
+    }
+
+    double rx_rate = (double)(s->frames_received - router->last_report.frames_received) / elapsed;
+    double fwd_rate = (double)(s->frames_forwarded - router->last_report.frames_forwarded) / elapsed;
+
+    printf("CAN router: rx %.0f fr/s, fwd %.0f fr/s | total rx %llu fwd %llu unrouted %llu "
+           "tx_drop %llu rx_drop %llu",
+           rx_rate, fwd_rate,
+           (unsigned long long)s->frames_received, (unsigned long long)s->frames_forwarded,
+           (unsigned long long)s->frames_unrouted, (unsigned long long)s->tx_dropped,
+           (unsigned long long)s->rx_dropped);
+    if (s->latency_samples > 0U)
+    {
+        printf(" | latency us min %.1f avg %.1f max %.1f",
+               (double)s->latency_ns_min / 1000.0,
+               (double)s->latency_ns_total / (double)s->latency_samples / 1000.0,
+               (double)s->latency_ns_max / 1000.0);
+    }
+    printf("\n");
+
+    router->last_report = *s;
+    router->last_report_time = now;
+}
+
+void can_router_close(struct can_router *router)
+{
+    if (NULL == router)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < router->num_ifaces; ++i)
+    {
+        if (router->ifaces[i].sock >= 0)
+        {
+            close(router->ifaces[i].sock);
+            router->ifaces[i].sock = -1;
+        }
+    }
+    router->num_ifaces = 0;
+
+    if (router->epoll_fd >= 0)
+    {
+        close(router->epoll_fd);
+        router->epoll_fd = -1;
+    }
+}
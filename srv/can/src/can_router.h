@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CAN_ROUTER_H
+#define CAN_ROUTER_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "can_receiver.h"
+#include "vehicle_signal.h"
+
+#define CAN_ROUTER_MAX_IFACES 8U   /*---distinct CAN interfaces handled by one router---*/
+#define CAN_ROUTER_MAX_ROUTES 64U  /*---entries in the routing table---*/
+#define CAN_ROUTE_KEEP_ID 0xFFFFFFFFU /*---new_id value forwarding the frame under its original ID---*/
+
+/**
+ * @brief One entry of the routing table.
+ *
+ * A frame received on src_ifname whose ID satisfies (can_id & mask) == (id & mask)
+ * is forwarded to dst_ifname as new_id. can_id carries the frame format flags, so
+ * a mask without CAN_EFF_FLAG also matches extended frames whose low bits equal id:
+ * use CAN_EFF_FLAG | CAN_SFF_MASK for one standard ID. new_id is the bare
+ * identifier, the forwarded frame keeps the EFF/RTR flags of the received one; it
+ * must fit 11 bits unless the route only matches extended frames (CAN_EFF_FLAG in
+ * both id and mask). If rewrite_src and rewrite_dst are set,
+ * the signal described by rewrite_src is decoded from the source payload and
+ * re-encoded into the forwarded payload using the rewrite_dst layout and scaling.
+ * A frame matching several entries is forwarded once per entry.
+ */
+struct can_route
+{
+    const char *src_ifname;
+    canid_t id;
+    canid_t mask;
+    const char *dst_ifname;
+    canid_t new_id;
+    const struct SignalDefinition *rewrite_src;
+    const struct SignalDefinition *rewrite_dst;
+};
+
+/**
+ * @brief Forwarding metrics of a router.
+ *
+ * Latency is measured from the kernel receive timestamp of a frame to the
+ * return of the sendmmsg() call that transmitted it.
+ */
+struct can_router_stats
+{
+    uint64_t frames_received;
+    uint64_t frames_forwarded;
+    uint64_t frames_unrouted;   /* received but matching no route */
+    uint64_t tx_dropped;        /* not accepted by the destination socket */
+    uint64_t rx_dropped;        /* dropped by the kernel receive queue (SO_RXQ_OVFL) */
+    uint64_t latency_ns_total;
+    uint64_t latency_ns_min;
+    uint64_t latency_ns_max;
+    uint64_t latency_samples;
+};
+
+struct can_router_iface
+{
+    char name[IFNAMSIZ];
+    int sock;
+    uint32_t last_ovfl_count;
+    unsigned int tx_count;                          /* frames pending in tx_frames */
+    struct can_frame tx_frames[CAN_RX_BATCH_MAX];
+    struct timespec tx_rx_time[CAN_RX_BATCH_MAX];   /* rx timestamp of each pending frame */
+};
+
+/**
+ * @brief Routing engine state. All buffers are embedded, so forwarding never allocates.
+ */
+struct can_router
+{
+    int epoll_fd;
+    unsigned int num_ifaces;
+    struct can_router_iface ifaces[CAN_ROUTER_MAX_IFACES];
+    unsigned int num_routes;
+    struct can_route routes[CAN_ROUTER_MAX_ROUTES];
+    uint8_t route_src[CAN_ROUTER_MAX_ROUTES];   /* iface index of each route's source */
+    uint8_t route_dst[CAN_ROUTER_MAX_ROUTES];   /* iface index of each route's destination */
+    struct can_router_stats stats;
+    struct can_router_stats last_report;
+    struct timespec last_report_time;
+};
+
+/**
+ * @brief Opens one socket per interface named in the routing table and installs
+ * kernel receive filters so only routed IDs reach user space.
+ *
+ * @param router Router state to initialize.
+ * @param routes The routing table, copied into the router.
+ * @param num_routes Number of entries in routes (max CAN_ROUTER_MAX_ROUTES).
+ * @return E_OK on success, E_NOT_OK on failure (all opened sockets are closed).
+ */
+int can_router_init(struct can_router *router, const struct can_route *routes, unsigned int num_routes);
+
+/**
+ * @brief Waits up to timeout_ms for traffic and forwards every frame queued on
+ * the source sockets, one recvmmsg()/sendmmsg() pair per interface and batch.
+ *
+ * @param router Initialized router.
+ * @param timeout_ms epoll timeout in milliseconds, -1 to block.
+ * @return Number of frames forwarded, or -1 on error.
+ */
+int can_router_poll(struct can_router *router, int timeout_ms);
+
+/**
+ * @brief Prints throughput since the previous report and latency statistics to stdout.
+ */
+void can_router_report(struct can_router *router);
+
+/**
+ * @brief Closes all sockets owned by the router.
+ */
+void can_router_close(struct can_router *router);
+
+#endif // CAN_ROUTER_H
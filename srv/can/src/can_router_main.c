@@ -0,0 +1,69 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "can_router.h"
+
+#define REPORT_INTERVAL_SEC 5
+
+extern struct can_route routes[];
+extern const unsigned int NUM_ROUTES;
+
+/**
+ * @brief Main function for the CAN gateway router.
+ *
+ * Forwards frames between the interfaces named in the routing table
+ * (can_routes.c) and periodically prints throughput and latency figures.
+ *
+ * @return 0 on successful execution and termination.
+ * 1 on error (e.g., socket initialization failure).
+ */
+int main(void)
+{
+    struct can_router router;
+    struct timespec now;
+    time_t next_report;
+
+    if (can_router_init(&router, routes, NUM_ROUTES) != E_OK)
+    {
+        fprintf(stderr, "Failed to initialize CAN router. Exiting.\n");
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    next_report = now.tv_sec + REPORT_INTERVAL_SEC;
+
+    while (1)
+    {
+        if (can_router_poll(&router, 1000) < 0)
+        {
+            break;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec >= next_report)
+        {
+            can_router_report(&router);
+            next_report = now.tv_sec + REPORT_INTERVAL_SEC;
+        }
+    }
+
+    can_router_close(&router);
+    return 1;
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "can_router.h"
+
+/*---Payload layout of the re-encoded speed on the destination bus---*/
+static const struct SignalDefinition gateway_speed = {
+    .name = "GatewayVehicleSpeed",
+    .can_id = 0x3B0,
+    .start_bit = 0,
+    .length = 16,
+    .scale = 0.01,
+    .offset = 0.0,
+    .is_signed = 0,
+    .is_big_endian = 0,
+    .unit = "km/h"
+};
+
+extern struct SignalDefinition signals[];
+
+struct can_route routes[] = {
+    {
+        /*---Engine RPM passed through unchanged---*/
+        .src_ifname = "vcan0",
+        .id = 0x1A0,
+        .mask = CAN_EFF_FLAG | CAN_SFF_MASK,
+        .dst_ifname = "vcan1",
+        .new_id = CAN_ROUTE_KEEP_ID,
+        .rewrite_src = NULL,
+        .rewrite_dst = NULL
+    },
+    {
+        /*---Vehicle speed remapped to 0x3B0 as little-endian 16 bit---*/
+        .src_ifname = "vcan0",
+        .id = 0x2B0,
+        .mask = CAN_EFF_FLAG | CAN_SFF_MASK,
+        .dst_ifname = "vcan1",
+        .new_id = 0x3B0,
+        .rewrite_src = &signals[1],
+        .rewrite_dst = &gateway_speed
+    },
+    {
+        /*---Diagnostic range 0x700-0x7FF bridged back to the powertrain bus---*/
+        .src_ifname = "vcan1",
+        .id = 0x700,
+        .mask = CAN_EFF_FLAG | 0x700,
+        .dst_ifname = "vcan0",
+        .new_id = CAN_ROUTE_KEEP_ID,
+        .rewrite_src = NULL,
+        .rewrite_dst = NULL
+    }
+};
+
+const unsigned int NUM_ROUTES = sizeof(routes) / sizeof(routes[0]);
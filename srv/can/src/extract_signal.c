@@ -22,12 +22,23 @@
 // Using 'ULL' for unsigned long long literal to ensure 64-bit operation.
 #define MASK64(nbits) ((nbits) == 0 ? 0ULL : (0xFFFFFFFFFFFFFFFFULL >> (64 - (nbits))))
 
+bool signalFitsFrame(uint16_t startbit, uint8_t length)
+{
+    if (length == 0 || length > 64)
+    {
+        return false;
+    }
+    // A 64 bit signal off a byte boundary spans 9 bytes, more than rawValue and the frame hold
+    uint16_t bytesSpanned = ((startbit % 8) + length + 7) / 8;
+    return (startbit / 8) + bytesSpanned <= SIGNAL_FRAME_BYTES;
+}
+
 uint64_t extractSignal(const uint8_t *frame, uint16_t startbit, uint8_t length, bool is_big_endian)
 {
     // Input Validation
-    if (length == 0 || length > 64)
+    if (!signalFitsFrame(startbit, length))
     {
-        return 0ULL; // Return 0 or handle error appropriately for invalid lengths
+        return 0ULL; // Return 0 for invalid lengths or signals reaching past the frame
     }
 
     // Determine the byte range involved
@@ -79,4 +90,57 @@ uint64_t extractSignal(const uint8_t *frame, uint16_t startbit, uint8_t length,
 
     // Mask to isolate the desired length bits
     return rawValue & MASK64(length);
-}
\ No newline at end of file
+}
+
+int insertSignal(uint8_t *frame, uint16_t startbit, uint8_t length, bool is_big_endian, uint64_t value)
+{
+    if (!signalFitsFrame(startbit, length))
+    {
+        return E_NOT_OK;
+    }
+
+    // Same byte range computation as extractSignal()
+    uint16_t startByte = startbit / 8;
+    uint8_t bitOffsetInStartByte = startbit % 8;
+    uint16_t endBit = startbit + length - 1;
+    uint16_t endByte = endBit / 8;
+    uint8_t bytesToFetch = endByte - startByte + 1;
+
+    uint64_t rawValue = 0ULL;
+    uint64_t mask;
+
+    if (is_big_endian)
+    {
+        for (uint8_t i = 0; i < bytesToFetch; ++i)
+        {
+            rawValue = (rawValue << 8) | frame[startByte + i];
+        }
+
+        uint8_t shift = (bytesToFetch * 8) - (bitOffsetInStartByte + length);
+        mask = MASK64(length) << shift;
+        rawValue = (rawValue & ~mask) | ((value << shift) & mask);
+
+        // Write back, least significant byte last
+        for (int i = bytesToFetch - 1; i >= 0; --i)
+        {
+            frame[startByte + i] = (uint8_t)(rawValue & 0xFFU);
+            rawValue >>= 8;
+        }
+    }
+    else
+    {
+        for (uint8_t i = 0; i < bytesToFetch; ++i)
+        {
+            rawValue |= ((uint64_t)frame[startByte + i]) << (i * 8);
+        }
+
+        mask = MASK64(length) << bitOffsetInStartByte;
+        rawValue = (rawValue & ~mask) | ((value << bitOffsetInStartByte) & mask);
+
+        for (uint8_t i = 0; i < bytesToFetch; ++i)
+        {
+            frame[startByte + i] = (uint8_t)(rawValue >> (i * 8));
+        }
+    }
+    return E_OK;
+}
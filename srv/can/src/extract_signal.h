@@ -19,6 +19,17 @@
 
 #include "osap_common.h"
 
+#define SIGNAL_FRAME_BYTES 8U /*---payload bytes of a classic CAN frame---*/
+
+/**
+ * @brief Checks that a signal lies within one CAN frame payload.
+ *
+ * @param startbit The 0-indexed starting bit position of the signal within the frame.
+ * @param length The length of the signal in bits.
+ * @return True if length is 1..64 and every byte the signal touches is inside SIGNAL_FRAME_BYTES.
+ */
+bool signalFitsFrame(uint16_t startbit, uint8_t length);
+
 /**
  * @brief Extracts a bitfield signal from a byte array.
  *
@@ -29,6 +40,23 @@
  * @param startbit The 0-indexed starting bit position of the signal within the frame.
  * @param length The length of the signal in bits (max 64 for uint64_t).
  * @param is_big_endian True if the frame data is big-endian, false for little-endian.
- * @return The extracted signal as a uint64_t. Returns 0 for invalid lengths.
+ * @return The extracted signal as a uint64_t. Returns 0 for invalid lengths or
+ * signals that do not fit the frame (see signalFitsFrame()).
+ */
+uint64_t extractSignal(const uint8_t *frame, uint16_t startbit, uint8_t length, bool is_big_endian);
+
+/**
+ * @brief Inserts a bitfield signal into a byte array.
+ *
+ * Inverse of extractSignal(): writes the lowest 'length' bits of 'value'
+ * at 'startbit' using the same bit numbering, leaving all other bits of
+ * the frame untouched.
+ *
+ * @param frame A pointer to the array of bytes of CAN frame to modify.
+ * @param startbit The 0-indexed starting bit position of the signal within the frame.
+ * @param length The length of the signal in bits (max 64).
+ * @param is_big_endian True if the frame data is big-endian, false for little-endian.
+ * @param value The raw signal value to store.
+ * @return E_OK, or E_NOT_OK without touching the frame if the signal does not fit (see signalFitsFrame()).
  */
-uint64_t extractSignal(const uint8_t *frame, uint16_t startbit, uint8_t length, bool is_big_endian);
\ No newline at end of file
+int insertSignal(uint8_t *frame, uint16_t startbit, uint8_t length, bool is_big_endian, uint64_t value);
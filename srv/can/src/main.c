@@ -23,6 +23,8 @@
 #include "can_receiver.h"
 #include "extract_signal.h"
 
+#define REPORT_INTERVAL_SEC 5
+
 extern struct SignalDefinition signals[];
 extern const int NUM_SIGNALS;
 
@@ -38,7 +40,8 @@ void sleep_ms(int milliseconds)
  * @brief Main function for the CAN frame listener application.
  *
  * This program initializes a CAN socket on a specified or default interface
- * and then continuously listens for and prints incoming CAN frames.
+ * and then continuously listens for incoming CAN frames, periodically
+ * printing the receive totals (frames, kernel drops, buffer growth).
  *
  * @param argc The number of command-line arguments.
  * @param argv An array of strings containing the command-line arguments.
@@ -52,7 +55,10 @@ int main(int argc, char **argv)
 {
     int sock_ = -1;
     const char *ifname = "vcan0"; // Default interface name
-    struct can_frame frame;
+    struct can_frame frames[CAN_RX_BATCH_MAX];
+    struct can_rx_stats rx_stats;
+    struct timespec now;
+    time_t next_report;
 
     // Parse command-line arguments
     if (argc > 2)
@@ -72,25 +78,40 @@ int main(int argc, char **argv)
         fprintf(stderr, "Failed to initialize CAN socket on interface '%s'. Exiting.\n", ifname);
         return 1;
     }
+    init_can_rx_stats(sock_, &rx_stats);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    next_report = now.tv_sec + REPORT_INTERVAL_SEC;
 
-
-    // Start receiving CAN frames
+    // Start receiving CAN frames, draining the socket queue in batches
     while (1)
     {
-        int receive_status = receive_can_frames(sock_, &frame);
+        int received = receive_can_frame_batch(sock_, frames, CAN_RX_BATCH_MAX, &rx_stats);
         uint64_t sig_val = 0;
 
-        if (E_OK == receive_status)
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec >= next_report)
+        {
+            report_can_rx_stats(&rx_stats);
+            next_report = now.tv_sec + REPORT_INTERVAL_SEC;
+        }
+
+        if (received < 0)
+        {
+            // Persistent socket errors would otherwise spin, back off before retrying
+            sleep_ms(100);
+            continue;
+        }
+
+        for (int f = 0; f < received; ++f)
         {
             for (int i = 0; i < NUM_SIGNALS; ++i)
             {
-                if (frame.can_id == signals[i].can_id)
+                if (frames[f].can_id == signals[i].can_id)
                 {
-                    sig_val = extractSignal((const uint8_t *)&frame.data, signals[i].start_bit, signals[i].length, signals[i].is_big_endian);
+                    sig_val = extractSignal((const uint8_t *)&frames[f].data, signals[i].start_bit, signals[i].length, signals[i].is_big_endian);
                 }
             }
         }
-        sleep_ms(100);
     }
     // Clean up: Close the socket
     if (close(sock_) < 0)
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DDS_H
+#define DDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lightweight DDS-like publish/subscribe between nodes over UDP multicast.
+ *
+ * Every participant joins one multicast group. Participants announce their
+ * writers and readers periodically; a writer only puts samples on the wire
+ * while a remote reader of its topic is alive, and peers whose type
+ * fingerprints differ for the same topic name are reported and never matched.
+ * Samples written close together share datagrams, across topics too.
+ *
+ * A KEEP_LAST writer keeps its last depth samples and announces their range in
+ * heartbeats; a KEEP_LAST reader delivers each writer's samples in order,
+ * buffering up to depth of them while it NACKs the gaps, and skips what the
+ * writer no longer holds. BEST_EFFORT samples are delivered as they arrive,
+ * a lost one is gone. A KEEP_LAST reader with a history starts each writer it
+ * meets that many samples back and has them repaired, so a late joiner gets
+ * the current state without waiting for the next write.
+ *
+ * Samples are fixed size, at most DDS_MAX_SAMPLE_SIZE bytes, exchanged in host
+ * byte order: all nodes of a domain must share endianness and type layouts.
+ */
+
+#define DDS_DEFAULT_GROUP "239.255.0.1"
+#define DDS_DEFAULT_PORT 7400U
+#define DDS_MAX_TOPICS 64U        /*---writers, and separately readers, per participant---*/
+#define DDS_MAX_TOPIC_NAME 64U    /*---including the terminating NUL---*/
+#define DDS_MAX_SAMPLE_SIZE 1024U /*---a sample always fits one datagram---*/
+#define DDS_MAX_DEPTH 1024U
+
+enum dds_reliability
+{
+    DDS_BEST_EFFORT = 0, /*---no history, no repair---*/
+    DDS_KEEP_LAST = 1    /*---the last depth samples are repaired on NACK---*/
+};
+
+struct dds_qos
+{
+    enum dds_reliability reliability;
+    uint32_t depth;   /*---KEEP_LAST only: samples held by the writer for repair and by the reader to reorder---*/
+    uint32_t history; /*---KEEP_LAST readers: samples written before the reader joined it asks for, at most depth---*/
+};
+
+struct dds_config
+{
+    const char *group;      /*---multicast group, NULL: DDS_DEFAULT_GROUP---*/
+    uint16_t port;          /*---0: DDS_DEFAULT_PORT---*/
+    const char *interface;  /*---address of the local interface, NULL: any; "127.0.0.1" keeps traffic on the host---*/
+    uint32_t domain;        /*---participants only talk to peers of the same domain---*/
+    uint32_t flush_us;      /*---longest a written sample waits for others to share its datagram, 0: sent at once---*/
+    uint32_t loss_permille; /*---test aid: received datagrams dropped on purpose to exercise repair, 0 in production---*/
+};
+
+struct dds_stats
+{
+    uint64_t samples_written;
+    uint64_t datagrams_sent;
+    uint64_t samples_delivered;
+    uint64_t samples_lost;        /*---skipped by readers, never received nor repaired---*/
+    uint64_t samples_retransmitted;
+    uint64_t nacks_sent;
+    uint64_t datagrams_dropped;   /*---by loss_permille---*/
+};
+
+/*---Called on the participant's receive thread; sample is aligned for any type---*/
+typedef void (*dds_sample_handler)(void *context, const void *sample, size_t size);
+
+struct dds_participant;
+
+/**
+ * @brief Joins the multicast group and starts the participant's receive thread,
+ * which also sends announcements, heartbeats and delayed batches.
+ *
+ * @param config Transport settings, NULL for the defaults.
+ * @return The participant, or NULL if the socket could not be set up.
+ */
+struct dds_participant *dds_participant_create(const struct dds_config *config);
+
+/**
+ * @brief Sends what is still batched, stops the receive thread and leaves the group.
+ */
+void dds_participant_destroy(struct dds_participant *participant);
+
+/**
+ * @brief Declares a writer of topic.
+ *
+ * @param fingerprint Identifies the sample type; readers with another fingerprint are not matched.
+ * @param qos NULL for BEST_EFFORT.
+ * @return Writer handle, or -1 if the parameters are invalid or DDS_MAX_TOPICS writers exist.
+ */
+int dds_create_writer(struct dds_participant *participant, const char *topic, uint64_t fingerprint,
+                      size_t sample_size, const struct dds_qos *qos);
+
+/**
+ * @brief Publishes count samples laid out back to back. They go out in as few
+ * datagrams as fit them, now or within flush_us.
+ *
+ * @return E_OK, or E_NOT_OK for an invalid writer.
+ */
+int dds_write(struct dds_participant *participant, int writer, const void *samples, size_t count);
+
+/**
+ * @brief Sends the samples waiting for flush_us to expire right away.
+ */
+void dds_flush(struct dds_participant *participant);
+
+/**
+ * @brief Declares a reader of topic; handler receives the samples of every matched remote writer.
+ *
+ * @param qos NULL for BEST_EFFORT. KEEP_LAST repairs only samples of KEEP_LAST writers.
+ * @return Reader handle, or -1 if the parameters are invalid or DDS_MAX_TOPICS readers exist.
+ */
+int dds_create_reader(struct dds_participant *participant, const char *topic, uint64_t fingerprint,
+                      size_t sample_size, const struct dds_qos *qos, dds_sample_handler handler, void *context);
+
+void dds_get_stats(struct dds_participant *participant, struct dds_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DDS_H
@@ -0,0 +1,225 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DDS_INTERNAL_H
+#define DDS_INTERNAL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <netinet/in.h>
+
+#include "dds.h"
+#include "osap_common.h"
+
+/*
+ * Wire format. A datagram is a dds_header followed by submessages, each a
+ * dds_submsg and length bytes of body. Fields are in host byte order and read
+ * with memcpy, bodies are not aligned.
+ */
+#define DDS_MAGIC 0x5344444FU /*---"ODDS"---*/
+#define DDS_PROTOCOL_VERSION 1U
+#define DDS_MAX_DATAGRAM 1472U /*---UDP payload of a 1500 byte Ethernet frame---*/
+
+enum dds_submsg_kind
+{
+    DDS_SUBMSG_ANNOUNCE = 1,  /*---an endpoint of the sender, body dds_announce---*/
+    DDS_SUBMSG_DATA = 2,      /*---consecutive samples of one writer, dds_data then count samples---*/
+    DDS_SUBMSG_HEARTBEAT = 3, /*---the sequence range a KEEP_LAST writer can still repair---*/
+    DDS_SUBMSG_NACK = 4       /*---sequences a reader is missing from one writer---*/
+};
+
+#define DDS_DATA_FLAG_REPAIRABLE 0x01U /*---DATA of a KEEP_LAST writer, gaps are worth a NACK---*/
+
+enum dds_role
+{
+    DDS_ROLE_WRITER = 1,
+    DDS_ROLE_READER = 2
+};
+
+struct dds_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t domain;
+    uint32_t reserved2;
+    uint64_t guid; /*---sending participant---*/
+};
+
+struct dds_submsg
+{
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t length; /*---of the body that follows---*/
+};
+
+struct dds_announce
+{
+    uint64_t key; /*---topic name and fingerprint, what DATA, HEARTBEAT and NACK refer to---*/
+    uint64_t name_hash;
+    uint64_t fingerprint;
+    uint32_t sample_size;
+    uint8_t role;
+    uint8_t reliability;
+    uint16_t depth;
+};
+
+struct dds_data
+{
+    uint64_t key;
+    uint64_t first_seq;
+    uint16_t count;
+    uint16_t sample_size;
+    uint32_t reserved;
+};
+
+struct dds_heartbeat
+{
+    uint64_t key;
+    uint64_t first_seq; /*---oldest sample still held---*/
+    uint64_t last_seq;  /*---newest sample written---*/
+};
+
+#define DDS_NACK_WINDOW 256U
+
+struct dds_nack
+{
+    uint64_t key;
+    uint64_t writer_guid;
+    uint64_t base_seq;
+    uint32_t bitmap[DDS_NACK_WINDOW / 32U]; /*---bit i set: base_seq + i is missing---*/
+};
+#define DDS_MAX_PEERS 16U             /*---remote writers a reader tracks---*/
+#define DDS_MAX_REMOTE_ENDPOINTS 256U
+#define DDS_ANNOUNCE_MS 500U
+#define DDS_LEASE_MS 2000U            /*---a peer silent for this long is forgotten---*/
+#define DDS_HEARTBEAT_MS 50U
+#define DDS_NACK_INTERVAL_MS 5U       /*---between two NACKs to the same writer---*/
+
+/*---A datagram being filled; consecutive samples of one writer extend one DATA submessage---*/
+struct dds_datagram
+{
+    unsigned char buf[DDS_MAX_DATAGRAM];
+    size_t len;         /*---0: empty, the header is written with the first submessage---*/
+    int writer;         /*---writer of the open DATA submessage, -1: none---*/
+    uint64_t next_seq;  /*---sequence that would extend it---*/
+    size_t data_offset; /*---of its dds_submsg---*/
+};
+
+struct dds_remote_endpoint
+{
+    uint64_t guid;
+    uint64_t key;
+    uint64_t name_hash;
+    uint64_t fingerprint;
+    uint64_t last_seen_ns;
+    uint32_t sample_size;
+    uint8_t role;
+    uint8_t in_use;
+};
+
+struct dds_writer
+{
+    char topic[DDS_MAX_TOPIC_NAME];
+    uint64_t key;
+    uint64_t name_hash;
+    uint64_t fingerprint;
+    uint32_t sample_size;
+    struct dds_qos qos;
+    uint64_t next_seq;      /*---starts at 1---*/
+    unsigned char *history; /*---KEEP_LAST: depth samples, sequence s in slot s % depth---*/
+    unsigned int matched;   /*---alive remote readers---*/
+};
+
+/*---What a reader knows about one remote writer; only touched by the receive thread---*/
+struct dds_reader_peer
+{
+    uint64_t guid;
+    uint64_t next_seq;      /*---next to deliver---*/
+    uint64_t highest_seq;   /*---newest known to exist---*/
+    uint64_t last_nack_ns;
+    int repairable;         /*---the writer keeps history---*/
+    unsigned char *slots;   /*---KEEP_LAST: depth samples received ahead of next_seq---*/
+    uint64_t *slot_seq;     /*---sequence held by each slot, 0: empty---*/
+};
+
+struct dds_reader
+{
+    char topic[DDS_MAX_TOPIC_NAME];
+    uint64_t key;
+    uint64_t name_hash;
+    uint64_t fingerprint;
+    uint32_t sample_size;
+    struct dds_qos qos;
+    dds_sample_handler handler;
+    void *context;
+    unsigned int num_peers;
+    struct dds_reader_peer peers[DDS_MAX_PEERS];
+};
+
+struct dds_participant
+{
+    struct dds_config config;
+    struct sockaddr_in group_addr;
+    uint64_t guid;
+    int sock;
+    int wake_fd; /*---eventfd, rouses the receive thread when a batch gets a deadline---*/
+    pthread_t thread;
+    atomic_int running;
+
+    /*---Guards everything below except the readers' peers, which belong to the receive thread---*/
+    pthread_mutex_t mutex;
+    unsigned int num_writers;
+    struct dds_writer writers[DDS_MAX_TOPICS];
+    unsigned int num_readers;
+    struct dds_reader readers[DDS_MAX_TOPICS];
+    struct dds_remote_endpoint remotes[DDS_MAX_REMOTE_ENDPOINTS];
+    struct dds_datagram out;   /*---batch of written samples---*/
+    uint64_t out_deadline_ns;  /*---when out must be sent, 0: nothing waiting---*/
+    uint64_t next_announce_ns;
+    struct dds_stats stats;
+
+    /*---Receive thread only---*/
+    struct dds_stats rx_stats; /*---added to stats once per datagram---*/
+    unsigned int loss_seed;
+    uint64_t next_heartbeat_ns;
+};
+
+/*---dds_participant.c---*/
+uint64_t dds_now_ns(void);
+uint64_t dds_fnv1a64(const void *data, size_t size, uint64_t hash);
+void dds_send(struct dds_participant *participant, struct dds_datagram *datagram);
+int dds_datagram_add(struct dds_participant *participant, struct dds_datagram *datagram, uint8_t kind,
+                     uint8_t flags, const void *body, size_t body_len);
+
+/*---dds_writer.c, callers hold the participant mutex---*/
+void dds_datagram_add_sample(struct dds_participant *participant, struct dds_datagram *datagram, int writer,
+                             uint64_t seq, const void *sample);
+void dds_writers_update_matches(struct dds_participant *participant);
+void dds_writers_heartbeat(struct dds_participant *participant);
+void dds_writer_on_nack(struct dds_participant *participant, const struct dds_nack *nack);
+
+/*---dds_reader.c, receive thread only---*/
+void dds_reader_on_data(struct dds_participant *participant, uint64_t guid, uint8_t flags,
+                        const struct dds_data *data, const unsigned char *samples);
+void dds_reader_on_heartbeat(struct dds_participant *participant, uint64_t guid,
+                             const struct dds_heartbeat *heartbeat);
+void dds_readers_send_nacks(struct dds_participant *participant); /*---takes the mutex---*/
+void dds_readers_forget_peer(struct dds_participant *participant, uint64_t guid);
+
+#endif // DDS_INTERNAL_H
@@ -0,0 +1,741 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define _GNU_SOURCE /*---ppoll()---*/
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/eventfd.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+
+#include "dds_internal.h"
+
+#define NSEC_PER_MSEC 1000000ULL
+#define DDS_RECV_BUFFER (1024 * 1024) /*---socket buffer, absorbs bursts while handlers run---*/
+
+uint64_t dds_now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/*---Same FNV-1a as the SignalBus topic hashes---*/
+uint64_t dds_fnv1a64(const void *data, size_t size, uint64_t hash)
+{
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*---Caller holds the mutex---*/
+void dds_send(struct dds_participant *participant, struct dds_datagram *datagram)
+{
+    if (datagram->len > 0U)
+    {
+        if (sendto(participant->sock, datagram->buf, datagram->len, 0, (const struct sockaddr *)&participant->group_addr,
+                   sizeof(participant->group_addr)) < 0)
+        {
+            perror("DDS: sendto failed");
+        }
+        else
+        {
+            participant->stats.datagrams_sent++;
+        }
+    }
+    datagram->len = 0;
+    datagram->writer = -1;
+}
+
+/*---Appends a submessage, sending the datagram first if it is full. E_NOT_OK if the body can never fit.---*/
+int dds_datagram_add(struct dds_participant *participant, struct dds_datagram *datagram, uint8_t kind,
+                     uint8_t flags, const void *body, size_t body_len)
+{
+    if (sizeof(struct dds_header) + sizeof(struct dds_submsg) + body_len > DDS_MAX_DATAGRAM)
+    {
+        return E_NOT_OK;
+    }
+    if (datagram->len + sizeof(struct dds_submsg) + body_len > DDS_MAX_DATAGRAM)
+    {
+        dds_send(participant, datagram);
+    }
+    if (datagram->len == 0U)
+    {
+        struct dds_header header = {DDS_MAGIC, DDS_PROTOCOL_VERSION, 0U, participant->config.domain, 0U,
+                                    participant->guid};
+        memcpy(datagram->buf, &header, sizeof(header));
+        datagram->len = sizeof(header);
+    }
+
+    struct dds_submsg submsg = {kind, flags, (uint16_t)body_len};
+    memcpy(datagram->buf + datagram->len, &submsg, sizeof(submsg));
+    memcpy(datagram->buf + datagram->len + sizeof(submsg), body, body_len);
+    datagram->len += sizeof(submsg) + body_len;
+    datagram->writer = -1;
+    return E_OK;
+}
+
+/*---Caller holds the mutex---*/
+static void announce(struct dds_participant *participant)
+{
+    struct dds_datagram datagram;
+    datagram.len = 0;
+    datagram.writer = -1;
+
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        const struct dds_writer *writer = &participant->writers[i];
+        struct dds_announce body = {writer->key, writer->name_hash, writer->fingerprint, writer->sample_size,
+                                    DDS_ROLE_WRITER, (uint8_t)writer->qos.reliability, (uint16_t)writer->qos.depth};
+        dds_datagram_add(participant, &datagram, DDS_SUBMSG_ANNOUNCE, 0U, &body, sizeof(body));
+    }
+    for (unsigned int i = 0; i < participant->num_readers; ++i)
+    {
+        const struct dds_reader *reader = &participant->readers[i];
+        struct dds_announce body = {reader->key, reader->name_hash, reader->fingerprint, reader->sample_size,
+                                    DDS_ROLE_READER, (uint8_t)reader->qos.reliability, (uint16_t)reader->qos.depth};
+        dds_datagram_add(participant, &datagram, DDS_SUBMSG_ANNOUNCE, 0U, &body, sizeof(body));
+    }
+    dds_send(participant, &datagram);
+    participant->next_announce_ns = dds_now_ns() + DDS_ANNOUNCE_MS * NSEC_PER_MSEC;
+}
+
+static const char *local_topic(const struct dds_participant *participant, uint64_t name_hash)
+{
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        if (participant->writers[i].name_hash == name_hash)
+        {
+            return participant->writers[i].topic;
+        }
+    }
+    for (unsigned int i = 0; i < participant->num_readers; ++i)
+    {
+        if (participant->readers[i].name_hash == name_hash)
+        {
+            return participant->readers[i].topic;
+        }
+    }
+    return NULL;
+}
+
+/*---True unless a local endpoint has the announced topic name but another fingerprint or sample size---*/
+static int matches_local_type(const struct dds_participant *participant, const struct dds_announce *body)
+{
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        const struct dds_writer *writer = &participant->writers[i];
+        if (writer->name_hash == body->name_hash &&
+            (writer->fingerprint != body->fingerprint || writer->sample_size != body->sample_size))
+        {
+            return 0;
+        }
+    }
+    for (unsigned int i = 0; i < participant->num_readers; ++i)
+    {
+        const struct dds_reader *reader = &participant->readers[i];
+        if (reader->name_hash == body->name_hash &&
+            (reader->fingerprint != body->fingerprint || reader->sample_size != body->sample_size))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*---Caller holds the mutex---*/
+static void on_announce(struct dds_participant *participant, uint64_t guid, const struct dds_announce *body,
+                        uint64_t now)
+{
+    struct dds_remote_endpoint *free_slot = NULL;
+    int known_peer = 0;
+
+    for (unsigned int i = 0; i < DDS_MAX_REMOTE_ENDPOINTS; ++i)
+    {
+        struct dds_remote_endpoint *remote = &participant->remotes[i];
+        if (!remote->in_use)
+        {
+            free_slot = (free_slot == NULL) ? remote : free_slot;
+            continue;
+        }
+        if (remote->guid == guid)
+        {
+            known_peer = 1;
+            if (remote->key == body->key && remote->role == body->role)
+            {
+                remote->last_seen_ns = now;
+                return;
+            }
+        }
+    }
+
+    /*---Same topic name, different type: would deliver garbage, so it is never matched---*/
+    const char *topic = local_topic(participant, body->name_hash);
+    if (topic != NULL && !matches_local_type(participant, body))
+    {
+        fprintf(stderr, "DDS Error: Peer %016llx uses another type for topic '%s', not matched.\n",
+                (unsigned long long)guid, topic);
+    }
+
+    if (NULL == free_slot)
+    {
+        fprintf(stderr, "DDS Warning: Too many remote endpoints (max %u), announcement ignored.\n",
+                DDS_MAX_REMOTE_ENDPOINTS);
+        return;
+    }
+    free_slot->guid = guid;
+    free_slot->key = body->key;
+    free_slot->name_hash = body->name_hash;
+    free_slot->fingerprint = body->fingerprint;
+    free_slot->sample_size = body->sample_size;
+    free_slot->role = body->role;
+    free_slot->last_seen_ns = now;
+    free_slot->in_use = 1;
+    dds_writers_update_matches(participant);
+
+    if (!known_peer)
+    {
+        /*---Answer right away, so the newcomer does not wait a full period to match us---*/
+        printf("DDS: Discovered participant %016llx.\n", (unsigned long long)guid);
+        participant->next_announce_ns = now;
+    }
+}
+
+/*---Receive thread; called with the mutex held, returns with it released---*/
+static void expire_peers(struct dds_participant *participant, uint64_t now)
+{
+    uint64_t expired[DDS_MAX_PEERS];
+    unsigned int num_expired = 0;
+    int changed = 0;
+
+    for (unsigned int i = 0; i < DDS_MAX_REMOTE_ENDPOINTS; ++i)
+    {
+        struct dds_remote_endpoint *remote = &participant->remotes[i];
+        if (remote->in_use && now - remote->last_seen_ns > DDS_LEASE_MS * NSEC_PER_MSEC)
+        {
+            remote->in_use = 0;
+            changed = 1;
+
+            unsigned int j = 0;
+            while (j < num_expired && expired[j] != remote->guid)
+            {
+                ++j;
+            }
+            if (j == num_expired && num_expired < DDS_MAX_PEERS)
+            {
+                expired[num_expired++] = remote->guid;
+            }
+        }
+    }
+    if (changed)
+    {
+        dds_writers_update_matches(participant);
+    }
+    pthread_mutex_unlock(&participant->mutex);
+
+    for (unsigned int j = 0; j < num_expired; ++j)
+    {
+        printf("DDS: Participant %016llx left.\n", (unsigned long long)expired[j]);
+        dds_readers_forget_peer(participant, expired[j]);
+    }
+}
+
+static int drop_on_purpose(struct dds_participant *participant)
+{
+    return participant->config.loss_permille > 0U &&
+           (unsigned int)(rand_r(&participant->loss_seed) % 1000) < participant->config.loss_permille;
+}
+
+/*---Receive thread---*/
+static void process_datagram(struct dds_participant *participant, const unsigned char *buf, size_t len)
+{
+    struct dds_header header;
+    if (len < sizeof(header))
+    {
+        return;
+    }
+    memcpy(&header, buf, sizeof(header));
+    if (header.magic != DDS_MAGIC || header.version != DDS_PROTOCOL_VERSION ||
+        header.domain != participant->config.domain || header.guid == participant->guid)
+    {
+        return; /*---foreign traffic, or our own looped back---*/
+    }
+
+    /*---Discovery is never dropped on purpose, the test aid targets data and repair---*/
+    struct dds_submsg first;
+    if (len >= sizeof(header) + sizeof(first))
+    {
+        memcpy(&first, buf + sizeof(header), sizeof(first));
+        if (first.kind != DDS_SUBMSG_ANNOUNCE && drop_on_purpose(participant))
+        {
+            participant->rx_stats.datagrams_dropped++;
+            return;
+        }
+    }
+
+    const uint64_t now = dds_now_ns();
+    size_t offset = sizeof(header);
+    while (offset + sizeof(struct dds_submsg) <= len)
+    {
+        struct dds_submsg submsg;
+        memcpy(&submsg, buf + offset, sizeof(submsg));
+        offset += sizeof(submsg);
+        if (offset + submsg.length > len)
+        {
+            break; /*---truncated---*/
+        }
+        const unsigned char *body = buf + offset;
+        offset += submsg.length;
+
+        if (submsg.kind == DDS_SUBMSG_ANNOUNCE && submsg.length >= sizeof(struct dds_announce))
+        {
+            struct dds_announce announce_body;
+            memcpy(&announce_body, body, sizeof(announce_body));
+            pthread_mutex_lock(&participant->mutex);
+            on_announce(participant, header.guid, &announce_body, now);
+            pthread_mutex_unlock(&participant->mutex);
+        }
+        else if (submsg.kind == DDS_SUBMSG_DATA && submsg.length >= sizeof(struct dds_data))
+        {
+            struct dds_data data;
+            memcpy(&data, body, sizeof(data));
+            if (sizeof(data) + (size_t)data.count * data.sample_size <= submsg.length)
+            {
+                dds_reader_on_data(participant, header.guid, submsg.flags, &data, body + sizeof(data));
+            }
+        }
+        else if (submsg.kind == DDS_SUBMSG_HEARTBEAT && submsg.length >= sizeof(struct dds_heartbeat))
+        {
+            struct dds_heartbeat heartbeat;
+            memcpy(&heartbeat, body, sizeof(heartbeat));
+            dds_reader_on_heartbeat(participant, header.guid, &heartbeat);
+        }
+        else if (submsg.kind == DDS_SUBMSG_NACK && submsg.length >= sizeof(struct dds_nack))
+        {
+            struct dds_nack nack;
+            memcpy(&nack, body, sizeof(nack));
+            if (nack.writer_guid == participant->guid)
+            {
+                pthread_mutex_lock(&participant->mutex);
+                dds_writer_on_nack(participant, &nack);
+                pthread_mutex_unlock(&participant->mutex);
+            }
+        }
+    }
+}
+
+static void merge_rx_stats(struct dds_participant *participant)
+{
+    struct dds_stats *rx = &participant->rx_stats;
+
+    pthread_mutex_lock(&participant->mutex);
+    participant->stats.samples_delivered += rx->samples_delivered;
+    participant->stats.samples_lost += rx->samples_lost;
+    participant->stats.nacks_sent += rx->nacks_sent;
+    participant->stats.datagrams_dropped += rx->datagrams_dropped;
+    pthread_mutex_unlock(&participant->mutex);
+    memset(rx, 0, sizeof(*rx));
+}
+
+static uint64_t earliest(uint64_t a, uint64_t b)
+{
+    return (a != 0U && a < b) ? a : b;
+}
+
+static void *receive_thread(void *arg)
+{
+    struct dds_participant *participant = arg;
+    unsigned char buf[DDS_MAX_DATAGRAM];
+    struct pollfd fds[2] = {{participant->sock, POLLIN, 0}, {participant->wake_fd, POLLIN, 0}};
+
+    while (atomic_load(&participant->running))
+    {
+        pthread_mutex_lock(&participant->mutex);
+        uint64_t deadline = earliest(participant->out_deadline_ns,
+                                     earliest(participant->next_announce_ns, participant->next_heartbeat_ns));
+        pthread_mutex_unlock(&participant->mutex);
+
+        uint64_t now = dds_now_ns();
+        uint64_t wait_ns = (deadline > now) ? deadline - now : 0U;
+        struct timespec timeout = {(time_t)(wait_ns / 1000000000ULL), (long)(wait_ns % 1000000000ULL)};
+        if (ppoll(fds, 2, &timeout, NULL) < 0 && errno != EINTR)
+        {
+            perror("DDS: ppoll failed");
+            break;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            uint64_t ignored;
+            if (read(participant->wake_fd, &ignored, sizeof(ignored)) < 0)
+            {
+                /*---nothing to do, the poll loop runs again anyway---*/
+            }
+        }
+        if (fds[0].revents & POLLIN)
+        {
+            ssize_t len;
+            while ((len = recv(participant->sock, buf, sizeof(buf), MSG_DONTWAIT)) > 0)
+            {
+                process_datagram(participant, buf, (size_t)len);
+            }
+            dds_readers_send_nacks(participant);
+            merge_rx_stats(participant);
+        }
+
+        now = dds_now_ns();
+        pthread_mutex_lock(&participant->mutex);
+        if (participant->out_deadline_ns != 0U && participant->out_deadline_ns <= now)
+        {
+            dds_send(participant, &participant->out);
+            participant->out_deadline_ns = 0;
+        }
+        if (participant->next_announce_ns <= now)
+        {
+            announce(participant);
+        }
+        if (participant->next_heartbeat_ns <= now)
+        {
+            participant->next_heartbeat_ns = now + DDS_HEARTBEAT_MS * NSEC_PER_MSEC;
+            dds_writers_heartbeat(participant);
+            expire_peers(participant, now); /*---releases the mutex---*/
+
+            /*---Retries NACKs whose repair was lost too---*/
+            dds_readers_send_nacks(participant);
+            merge_rx_stats(participant);
+        }
+        else
+        {
+            pthread_mutex_unlock(&participant->mutex);
+        }
+    }
+    return NULL;
+}
+
+static int open_socket(struct dds_participant *participant, const struct dds_config *config)
+{
+    const char *group = (config->group != NULL) ? config->group : DDS_DEFAULT_GROUP;
+    const uint16_t port = (config->port != 0U) ? config->port : (uint16_t)DDS_DEFAULT_PORT;
+    struct in_addr interface_addr = {htonl(INADDR_ANY)};
+    int enable = 1;
+    int buffer = DDS_RECV_BUFFER;
+    unsigned char ttl = 1;
+
+    memset(&participant->group_addr, 0, sizeof(participant->group_addr));
+    participant->group_addr.sin_family = AF_INET;
+    participant->group_addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, group, &participant->group_addr.sin_addr) != 1 ||
+        (config->interface != NULL && inet_pton(AF_INET, config->interface, &interface_addr) != 1))
+    {
+        fprintf(stderr, "DDS Error: Invalid multicast group '%s' or interface address.\n", group);
+        return E_NOT_OK;
+    }
+
+    participant->sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (participant->sock < 0)
+    {
+        perror("DDS: socket failed");
+        return E_NOT_OK;
+    }
+
+    /*---Several participants on one host share the port, each gets a copy of every datagram---*/
+    struct sockaddr_in bind_addr;
+    memset(&bind_addr, 0, sizeof(bind_addr));
+    bind_addr.sin_family = AF_INET;
+    bind_addr.sin_port = htons(port);
+    bind_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    struct ip_mreq membership;
+    membership.imr_multiaddr = participant->group_addr.sin_addr;
+    membership.imr_interface = interface_addr;
+
+    if (setsockopt(participant->sock, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0 ||
+        bind(participant->sock, (const struct sockaddr *)&bind_addr, sizeof(bind_addr)) < 0 ||
+        setsockopt(participant->sock, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0 ||
+        setsockopt(participant->sock, IPPROTO_IP, IP_MULTICAST_IF, &interface_addr, sizeof(interface_addr)) < 0 ||
+        setsockopt(participant->sock, IPPROTO_IP, IP_MULTICAST_LOOP, &enable, sizeof(enable)) < 0 ||
+        setsockopt(participant->sock, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) < 0)
+    {
+        perror("DDS: joining the multicast group failed");
+        close(participant->sock);
+        return E_NOT_OK;
+    }
+    if (setsockopt(participant->sock, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer)) < 0)
+    {
+        perror("DDS: setsockopt SO_RCVBUF failed, bursts may be dropped");
+    }
+    return E_OK;
+}
+
+struct dds_participant *dds_participant_create(const struct dds_config *config)
+{
+    static const struct dds_config defaults = {NULL, 0U, NULL, 0U, 0U, 0U};
+    struct dds_participant *participant = calloc(1, sizeof(*participant));
+    if (NULL == participant)
+    {
+        return NULL;
+    }
+    participant->config = (config != NULL) ? *config : defaults;
+    participant->out.writer = -1;
+
+    if (getrandom(&participant->guid, sizeof(participant->guid), 0) != (ssize_t)sizeof(participant->guid))
+    {
+        participant->guid = dds_now_ns() ^ ((uint64_t)getpid() << 32);
+    }
+    participant->loss_seed = (unsigned int)participant->guid;
+
+    if (open_socket(participant, &participant->config) != E_OK)
+    {
+        free(participant);
+        return NULL;
+    }
+    participant->wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (participant->wake_fd < 0)
+    {
+        perror("DDS: eventfd failed");
+        close(participant->sock);
+        free(participant);
+        return NULL;
+    }
+
+    pthread_mutex_init(&participant->mutex, NULL);
+    participant->next_announce_ns = dds_now_ns();
+    participant->next_heartbeat_ns = participant->next_announce_ns;
+    atomic_store(&participant->running, 1);
+    if (pthread_create(&participant->thread, NULL, receive_thread, participant) != 0)
+    {
+        fprintf(stderr, "DDS Error: Could not start the receive thread.\n");
+        pthread_mutex_destroy(&participant->mutex);
+        close(participant->wake_fd);
+        close(participant->sock);
+        free(participant);
+        return NULL;
+    }
+    return participant;
+}
+
+static void wake(struct dds_participant *participant)
+{
+    uint64_t one = 1;
+    if (write(participant->wake_fd, &one, sizeof(one)) < 0)
+    {
+        /*---the counter is already non-zero, the thread wakes anyway---*/
+    }
+}
+
+void dds_participant_destroy(struct dds_participant *participant)
+{
+    if (NULL == participant)
+    {
+        return;
+    }
+
+    atomic_store(&participant->running, 0);
+    wake(participant);
+    pthread_join(participant->thread, NULL);
+    dds_flush(participant);
+
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        free(participant->writers[i].history);
+    }
+    for (unsigned int i = 0; i < participant->num_readers; ++i)
+    {
+        for (unsigned int j = 0; j < participant->readers[i].num_peers; ++j)
+        {
+            free(participant->readers[i].peers[j].slots);
+            free(participant->readers[i].peers[j].slot_seq);
+        }
+    }
+    pthread_mutex_destroy(&participant->mutex);
+    close(participant->wake_fd);
+    close(participant->sock);
+    free(participant);
+}
+
+/*---Shared by writers and readers: validates the endpoint and derives its keys---*/
+static int describe_endpoint(const char *topic, uint64_t fingerprint, size_t sample_size, const struct dds_qos *qos,
+                             char *name, uint64_t *name_hash, uint64_t *key, struct dds_qos *qos_out)
+{
+    static const struct dds_qos best_effort = {DDS_BEST_EFFORT, 0U, 0U};
+
+    if (NULL == topic || strlen(topic) >= DDS_MAX_TOPIC_NAME || sample_size == 0U ||
+        sample_size > DDS_MAX_SAMPLE_SIZE ||
+        (qos != NULL && qos->reliability == DDS_KEEP_LAST &&
+         (qos->depth == 0U || qos->depth > DDS_MAX_DEPTH || qos->history > qos->depth)))
+    {
+        fprintf(stderr, "DDS Error: Invalid endpoint for topic '%s'.\n", (topic != NULL) ? topic : "(null)");
+        return E_NOT_OK;
+    }
+    strcpy(name, topic);
+    *name_hash = dds_fnv1a64(topic, strlen(topic), 14695981039346656037ULL);
+    *key = dds_fnv1a64(&fingerprint, sizeof(fingerprint), *name_hash);
+    *qos_out = (qos != NULL) ? *qos : best_effort;
+    return E_OK;
+}
+
+int dds_create_writer(struct dds_participant *participant, const char *topic, uint64_t fingerprint,
+                      size_t sample_size, const struct dds_qos *qos)
+{
+    if (NULL == participant)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&participant->mutex);
+    int id = -1;
+    struct dds_writer *writer = &participant->writers[participant->num_writers];
+    if (participant->num_writers < DDS_MAX_TOPICS &&
+        describe_endpoint(topic, fingerprint, sample_size, qos, writer->topic, &writer->name_hash, &writer->key,
+                          &writer->qos) == E_OK)
+    {
+        writer->fingerprint = fingerprint;
+        writer->sample_size = (uint32_t)sample_size;
+        writer->next_seq = 1;
+        writer->history = NULL;
+        if (writer->qos.reliability == DDS_KEEP_LAST)
+        {
+            writer->history = malloc((size_t)writer->qos.depth * sample_size);
+        }
+        if (writer->qos.reliability != DDS_KEEP_LAST || writer->history != NULL)
+        {
+            id = (int)participant->num_writers++;
+            dds_writers_update_matches(participant);
+            participant->next_announce_ns = dds_now_ns();
+        }
+    }
+    pthread_mutex_unlock(&participant->mutex);
+
+    if (id >= 0)
+    {
+        wake(participant);
+    }
+    return id;
+}
+
+int dds_create_reader(struct dds_participant *participant, const char *topic, uint64_t fingerprint,
+                      size_t sample_size, const struct dds_qos *qos, dds_sample_handler handler, void *context)
+{
+    if (NULL == participant || NULL == handler)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&participant->mutex);
+    int id = -1;
+    struct dds_reader *reader = &participant->readers[participant->num_readers];
+    if (participant->num_readers < DDS_MAX_TOPICS &&
+        describe_endpoint(topic, fingerprint, sample_size, qos, reader->topic, &reader->name_hash, &reader->key,
+                          &reader->qos) == E_OK)
+    {
+        reader->fingerprint = fingerprint;
+        reader->sample_size = (uint32_t)sample_size;
+        reader->handler = handler;
+        reader->context = context;
+        reader->num_peers = 0;
+        id = (int)participant->num_readers++; /*---published to the receive thread by the mutex---*/
+        participant->next_announce_ns = dds_now_ns();
+    }
+    pthread_mutex_unlock(&participant->mutex);
+
+    if (id >= 0)
+    {
+        wake(participant);
+    }
+    return id;
+}
+
+int dds_write(struct dds_participant *participant, int writer_id, const void *samples, size_t count)
+{
+    if (NULL == participant || writer_id < 0 || (unsigned int)writer_id >= DDS_MAX_TOPICS)
+    {
+        return E_NOT_OK;
+    }
+
+    int schedule = 0;
+    pthread_mutex_lock(&participant->mutex);
+    if ((unsigned int)writer_id >= participant->num_writers)
+    {
+        pthread_mutex_unlock(&participant->mutex);
+        return E_NOT_OK;
+    }
+
+    struct dds_writer *writer = &participant->writers[writer_id];
+    const unsigned char *sample = samples;
+    for (size_t i = 0; i < count; ++i, sample += writer->sample_size)
+    {
+        const uint64_t seq = writer->next_seq++;
+        if (writer->history != NULL)
+        {
+            memcpy(writer->history + (seq % writer->qos.depth) * writer->sample_size, sample, writer->sample_size);
+        }
+        /*---Nobody listens: only the history is kept, so a reader joining soon can still be repaired---*/
+        if (writer->matched > 0U)
+        {
+            dds_datagram_add_sample(participant, &participant->out, writer_id, seq, sample);
+        }
+    }
+    participant->stats.samples_written += count;
+
+    if (participant->out.len > 0U)
+    {
+        if (participant->config.flush_us == 0U)
+        {
+            dds_send(participant, &participant->out);
+        }
+        else if (participant->out_deadline_ns == 0U)
+        {
+            participant->out_deadline_ns = dds_now_ns() + (uint64_t)participant->config.flush_us * 1000U;
+            schedule = 1;
+        }
+    }
+    pthread_mutex_unlock(&participant->mutex);
+
+    if (schedule)
+    {
+        wake(participant);
+    }
+    return E_OK;
+}
+
+void dds_flush(struct dds_participant *participant)
+{
+    if (NULL == participant)
+    {
+        return;
+    }
+    pthread_mutex_lock(&participant->mutex);
+    dds_send(participant, &participant->out);
+    participant->out_deadline_ns = 0;
+    pthread_mutex_unlock(&participant->mutex);
+}
+
+void dds_get_stats(struct dds_participant *participant, struct dds_stats *stats)
+{
+    pthread_mutex_lock(&participant->mutex);
+    *stats = participant->stats;
+    pthread_mutex_unlock(&participant->mutex);
+}
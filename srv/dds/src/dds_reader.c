@@ -0,0 +1,293 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dds_internal.h"
+
+/*
+ * Reader side, run on the receive thread. Handlers are called without the
+ * participant mutex, so they may write samples themselves.
+ */
+
+#define NSEC_PER_MSEC 1000000ULL
+
+static struct dds_reader *find_reader(struct dds_participant *participant, uint64_t key)
+{
+    pthread_mutex_lock(&participant->mutex);
+    const unsigned int num_readers = participant->num_readers;
+    pthread_mutex_unlock(&participant->mutex);
+
+    for (unsigned int i = 0; i < num_readers; ++i)
+    {
+        if (participant->readers[i].key == key)
+        {
+            return &participant->readers[i];
+        }
+    }
+    return NULL;
+}
+
+/*---next_seq of a new peer: where this reader starts following the writer---*/
+static struct dds_reader_peer *find_peer(struct dds_reader *reader, uint64_t guid, uint64_t next_seq)
+{
+    for (unsigned int i = 0; i < reader->num_peers; ++i)
+    {
+        if (reader->peers[i].guid == guid)
+        {
+            return &reader->peers[i];
+        }
+    }
+    if (reader->num_peers >= DDS_MAX_PEERS)
+    {
+        return NULL;
+    }
+
+    struct dds_reader_peer *peer = &reader->peers[reader->num_peers];
+    memset(peer, 0, sizeof(*peer));
+    if (reader->qos.reliability == DDS_KEEP_LAST)
+    {
+        peer->slots = malloc((size_t)reader->qos.depth * reader->sample_size);
+        peer->slot_seq = calloc(reader->qos.depth, sizeof(uint64_t));
+        if (NULL == peer->slots || NULL == peer->slot_seq)
+        {
+            free(peer->slots);
+            free(peer->slot_seq);
+            return NULL;
+        }
+    }
+    peer->guid = guid;
+    peer->next_seq = next_seq;
+    peer->highest_seq = next_seq - 1U;
+    reader->num_peers++;
+    return peer;
+}
+
+/*---A peer just met is followed from first_new, or up to history samples earlier still held---*/
+static uint64_t join_seq(const struct dds_reader *reader, uint64_t first_new, uint64_t first_held)
+{
+    const uint64_t held = first_new - first_held;
+    const uint64_t history = (reader->qos.reliability == DDS_KEEP_LAST) ? reader->qos.history : 0U;
+    return first_new - ((history < held) ? history : held);
+}
+
+static void deliver(struct dds_participant *participant, const struct dds_reader *reader, const void *sample)
+{
+    /*---Samples lie unaligned in the datagram, handlers may read them as their type---*/
+    max_align_t aligned[(DDS_MAX_SAMPLE_SIZE + sizeof(max_align_t) - 1) / sizeof(max_align_t)];
+    memcpy(aligned, sample, reader->sample_size);
+    reader->handler(reader->context, aligned, reader->sample_size);
+    participant->rx_stats.samples_delivered++;
+}
+
+/*---Delivers what is buffered below 'to' in order and gives up on the rest---*/
+static void skip_to(struct dds_participant *participant, const struct dds_reader *reader,
+                    struct dds_reader_peer *peer, uint64_t to)
+{
+    const uint64_t depth = reader->qos.depth;
+    const uint64_t end = (to - peer->next_seq > depth) ? peer->next_seq + depth : to;
+
+    for (uint64_t seq = peer->next_seq; seq < end; ++seq)
+    {
+        const size_t slot = (size_t)(seq % depth);
+        if (peer->slot_seq[slot] == seq)
+        {
+            peer->slot_seq[slot] = 0;
+            deliver(participant, reader, peer->slots + slot * reader->sample_size);
+        }
+        else
+        {
+            participant->rx_stats.samples_lost++;
+        }
+    }
+    participant->rx_stats.samples_lost += to - end;
+    peer->next_seq = to;
+}
+
+static void on_sample(struct dds_participant *participant, const struct dds_reader *reader,
+                      struct dds_reader_peer *peer, uint64_t seq, const unsigned char *sample)
+{
+    if (seq < peer->next_seq)
+    {
+        return; /*---duplicate, e.g. a repair another reader asked for---*/
+    }
+    if (seq > peer->highest_seq)
+    {
+        peer->highest_seq = seq;
+    }
+
+    if (NULL == peer->slots || !peer->repairable)
+    {
+        participant->rx_stats.samples_lost += seq - peer->next_seq;
+        peer->next_seq = seq + 1U;
+        deliver(participant, reader, sample);
+        return;
+    }
+
+    const uint64_t depth = reader->qos.depth;
+    if (seq >= peer->next_seq + depth)
+    {
+        /*---Keep last: samples older than depth behind the newest are not worth waiting for---*/
+        skip_to(participant, reader, peer, seq - depth + 1U);
+    }
+    if (seq != peer->next_seq)
+    {
+        const size_t slot = (size_t)(seq % depth);
+        memcpy(peer->slots + slot * reader->sample_size, sample, reader->sample_size);
+        peer->slot_seq[slot] = seq;
+        return;
+    }
+
+    deliver(participant, reader, sample);
+    peer->next_seq++;
+    for (size_t slot = (size_t)(peer->next_seq % depth); peer->slot_seq[slot] == peer->next_seq;
+         slot = (size_t)(peer->next_seq % depth))
+    {
+        peer->slot_seq[slot] = 0;
+        deliver(participant, reader, peer->slots + slot * reader->sample_size);
+        peer->next_seq++;
+    }
+}
+
+void dds_reader_on_data(struct dds_participant *participant, uint64_t guid, uint8_t flags,
+                        const struct dds_data *data, const unsigned char *samples)
+{
+    struct dds_reader *reader = find_reader(participant, data->key);
+    if (NULL == reader || data->sample_size != reader->sample_size || data->count == 0U)
+    {
+        return;
+    }
+    /*---Only a KEEP_LAST writer can hand out what it wrote before; 1 is the first sequence it ever wrote---*/
+    const int repairable = (flags & DDS_DATA_FLAG_REPAIRABLE) != 0U;
+    struct dds_reader_peer *peer =
+        find_peer(reader, guid, repairable ? join_seq(reader, data->first_seq, 1U) : data->first_seq);
+    if (NULL == peer)
+    {
+        return;
+    }
+    peer->repairable = repairable;
+
+    for (uint16_t i = 0; i < data->count; ++i)
+    {
+        on_sample(participant, reader, peer, data->first_seq + i, samples + (size_t)i * reader->sample_size);
+    }
+}
+
+void dds_reader_on_heartbeat(struct dds_participant *participant, uint64_t guid,
+                             const struct dds_heartbeat *heartbeat)
+{
+    struct dds_reader *reader = find_reader(participant, heartbeat->key);
+    if (NULL == reader || reader->qos.reliability != DDS_KEEP_LAST)
+    {
+        return;
+    }
+
+    /*---A reader meeting the writer through a heartbeat follows it from the next sample on, or its history---*/
+    struct dds_reader_peer *peer =
+        find_peer(reader, guid, join_seq(reader, heartbeat->last_seq + 1U, heartbeat->first_seq));
+    if (NULL == peer)
+    {
+        return;
+    }
+    peer->repairable = 1;
+    if (heartbeat->first_seq > peer->next_seq)
+    {
+        skip_to(participant, reader, peer, heartbeat->first_seq);
+    }
+    if (heartbeat->last_seq > peer->highest_seq)
+    {
+        peer->highest_seq = heartbeat->last_seq; /*---the tail of a burst was lost---*/
+    }
+}
+
+void dds_readers_send_nacks(struct dds_participant *participant)
+{
+    const uint64_t now = dds_now_ns();
+    struct dds_datagram datagram;
+    datagram.len = 0;
+    datagram.writer = -1;
+
+    pthread_mutex_lock(&participant->mutex);
+    for (unsigned int i = 0; i < participant->num_readers; ++i)
+    {
+        struct dds_reader *reader = &participant->readers[i];
+        for (unsigned int j = 0; j < reader->num_peers; ++j)
+        {
+            struct dds_reader_peer *peer = &reader->peers[j];
+            if (NULL == peer->slots || !peer->repairable || peer->highest_seq < peer->next_seq ||
+                now - peer->last_nack_ns < DDS_NACK_INTERVAL_MS * NSEC_PER_MSEC)
+            {
+                continue;
+            }
+
+            /*---Everything missing between what was delivered and the newest known, at most depth---*/
+            const uint64_t end = (peer->highest_seq - peer->next_seq < reader->qos.depth)
+                                     ? peer->highest_seq + 1U
+                                     : peer->next_seq + reader->qos.depth;
+            for (uint64_t base = peer->next_seq; base < end; base += DDS_NACK_WINDOW)
+            {
+                struct dds_nack nack;
+                memset(&nack, 0, sizeof(nack));
+                nack.key = reader->key;
+                nack.writer_guid = peer->guid;
+                nack.base_seq = base;
+
+                int missing = 0;
+                for (unsigned int bit = 0; bit < DDS_NACK_WINDOW && base + bit < end; ++bit)
+                {
+                    const uint64_t seq = base + bit;
+                    if (peer->slot_seq[seq % reader->qos.depth] != seq)
+                    {
+                        nack.bitmap[bit / 32U] |= 1U << (bit % 32U);
+                        missing = 1;
+                    }
+                }
+                if (missing)
+                {
+                    dds_datagram_add(participant, &datagram, DDS_SUBMSG_NACK, 0U, &nack, sizeof(nack));
+                    participant->rx_stats.nacks_sent++;
+                }
+            }
+            peer->last_nack_ns = now;
+        }
+    }
+    dds_send(participant, &datagram);
+    pthread_mutex_unlock(&participant->mutex);
+}
+
+void dds_readers_forget_peer(struct dds_participant *participant, uint64_t guid)
+{
+    pthread_mutex_lock(&participant->mutex);
+    const unsigned int num_readers = participant->num_readers;
+    pthread_mutex_unlock(&participant->mutex);
+
+    for (unsigned int i = 0; i < num_readers; ++i)
+    {
+        struct dds_reader *reader = &participant->readers[i];
+        for (unsigned int j = 0; j < reader->num_peers; ++j)
+        {
+            if (reader->peers[j].guid == guid)
+            {
+                free(reader->peers[j].slots);
+                free(reader->peers[j].slot_seq);
+                reader->peers[j] = reader->peers[--reader->num_peers];
+                break;
+            }
+        }
+    }
+}
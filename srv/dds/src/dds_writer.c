@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#include "dds_internal.h"
+
+/*---Writer side: batching into datagrams, heartbeats and repair. Callers hold the participant mutex.---*/
+
+void dds_datagram_add_sample(struct dds_participant *participant, struct dds_datagram *datagram, int writer_id,
+                             uint64_t seq, const void *sample)
+{
+    const struct dds_writer *writer = &participant->writers[writer_id];
+    const size_t size = writer->sample_size;
+
+    /*---The next sample of the same writer only costs its bytes---*/
+    if (datagram->len > 0U && datagram->writer == writer_id && datagram->next_seq == seq &&
+        datagram->len + size <= DDS_MAX_DATAGRAM)
+    {
+        struct dds_submsg submsg;
+        struct dds_data data;
+        unsigned char *head = datagram->buf + datagram->data_offset;
+
+        memcpy(&submsg, head, sizeof(submsg));
+        memcpy(&data, head + sizeof(submsg), sizeof(data));
+        if (data.count < UINT16_MAX)
+        {
+            submsg.length = (uint16_t)(submsg.length + size);
+            data.count++;
+            memcpy(head, &submsg, sizeof(submsg));
+            memcpy(head + sizeof(submsg), &data, sizeof(data));
+            memcpy(datagram->buf + datagram->len, sample, size);
+            datagram->len += size;
+            datagram->next_seq = seq + 1U;
+            return;
+        }
+    }
+
+    unsigned char body[sizeof(struct dds_data) + DDS_MAX_SAMPLE_SIZE];
+    struct dds_data data = {writer->key, seq, 1U, (uint16_t)size, 0U};
+    memcpy(body, &data, sizeof(data));
+    memcpy(body + sizeof(data), sample, size);
+    const uint8_t flags = (writer->history != NULL) ? DDS_DATA_FLAG_REPAIRABLE : 0U;
+    dds_datagram_add(participant, datagram, DDS_SUBMSG_DATA, flags, body, sizeof(data) + size);
+
+    datagram->data_offset = datagram->len - sizeof(struct dds_submsg) - sizeof(data) - size;
+    datagram->writer = writer_id;
+    datagram->next_seq = seq + 1U;
+}
+
+void dds_writers_update_matches(struct dds_participant *participant)
+{
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        struct dds_writer *writer = &participant->writers[i];
+        writer->matched = 0;
+        for (unsigned int j = 0; j < DDS_MAX_REMOTE_ENDPOINTS; ++j)
+        {
+            const struct dds_remote_endpoint *remote = &participant->remotes[j];
+            if (remote->in_use && remote->role == DDS_ROLE_READER && remote->key == writer->key)
+            {
+                writer->matched++;
+            }
+        }
+    }
+}
+
+/*---Oldest sequence a KEEP_LAST writer can still repair---*/
+static uint64_t first_held(const struct dds_writer *writer)
+{
+    return (writer->next_seq > writer->qos.depth) ? writer->next_seq - writer->qos.depth : 1U;
+}
+
+void dds_writers_heartbeat(struct dds_participant *participant)
+{
+    struct dds_datagram datagram;
+    datagram.len = 0;
+    datagram.writer = -1;
+
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        const struct dds_writer *writer = &participant->writers[i];
+        if (writer->history != NULL && writer->matched > 0U && writer->next_seq > 1U)
+        {
+            struct dds_heartbeat heartbeat = {writer->key, first_held(writer), writer->next_seq - 1U};
+            dds_datagram_add(participant, &datagram, DDS_SUBMSG_HEARTBEAT, 0U, &heartbeat, sizeof(heartbeat));
+        }
+    }
+    dds_send(participant, &datagram);
+}
+
+void dds_writer_on_nack(struct dds_participant *participant, const struct dds_nack *nack)
+{
+    for (unsigned int i = 0; i < participant->num_writers; ++i)
+    {
+        const struct dds_writer *writer = &participant->writers[i];
+        if (writer->key != nack->key || NULL == writer->history)
+        {
+            continue;
+        }
+
+        /*---Repairs go to the whole group, every reader missing the same samples is served at once---*/
+        struct dds_datagram datagram;
+        datagram.len = 0;
+        datagram.writer = -1;
+        for (unsigned int bit = 0; bit < DDS_NACK_WINDOW; ++bit)
+        {
+            const uint64_t seq = nack->base_seq + bit;
+            if ((nack->bitmap[bit / 32U] & (1U << (bit % 32U))) && seq >= first_held(writer) &&
+                seq < writer->next_seq)
+            {
+                dds_datagram_add_sample(participant, &datagram, (int)i,
+                                        seq, writer->history + (seq % writer->qos.depth) * writer->sample_size);
+                participant->stats.samples_retransmitted++;
+            }
+        }
+        dds_send(participant, &datagram);
+        return;
+    }
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Exercises the DDS transport between processes on one host.
+ *
+ *   dds_loopback sub <topic> [options]     prints what arrived, the gaps in the sequence and the latency
+ *   dds_loopback pub <topic> [options]     publishes numbered samples
+ *
+ * Options:
+ *   --count <n>       samples to publish, or to wait for (default 10000)
+ *   --batch <n>       samples per dds_write() (default 1)
+ *   --period-us <n>   pause between two writes (default 100)
+ *   --keep-last <n>   KEEP_LAST with depth n instead of BEST_EFFORT
+ *   --history <n>     subscriber with KEEP_LAST: also ask for the n samples written before it joined
+ *   --loss <permille> drop received datagrams on purpose, to see repair at work
+ *   --flush-us <n>    batching delay of the participant (default 0)
+ *   --seconds <n>     subscriber gives up after this long (default 30)
+ *
+ * Traffic stays on 127.0.0.1. Start several subscribers, with and without
+ * --loss, then a publisher, e.g.:
+ *
+ *   dds_loopback sub demo --keep-last 256 --loss 50 &
+ *   dds_loopback sub demo &
+ *   dds_loopback pub demo --keep-last 256 --batch 8
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dds.h"
+
+#define LOOPBACK_FINGERPRINT 0x4c4f4f504241434bULL
+
+struct loopback_sample
+{
+    uint64_t seq;
+    uint64_t sent_ns;
+};
+
+struct loopback_receiver
+{
+    uint64_t received;
+    uint64_t next_seq;
+    uint64_t gaps;
+    uint64_t latency_ns_total;
+    uint64_t latency_ns_max;
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static void sleep_us(unsigned long us)
+{
+    struct timespec pause = {(time_t)(us / 1000000UL), (long)(us % 1000000UL) * 1000L};
+    nanosleep(&pause, NULL);
+}
+
+static void on_sample(void *context, const void *sample, size_t size)
+{
+    struct loopback_receiver *receiver = context;
+    const struct loopback_sample *value = sample;
+    uint64_t latency = now_ns() - value->sent_ns;
+    (void)size;
+
+    if (receiver->received > 0U && value->seq != receiver->next_seq)
+    {
+        receiver->gaps++;
+    }
+    receiver->next_seq = value->seq + 1U;
+    receiver->received++;
+    receiver->latency_ns_total += latency;
+    receiver->latency_ns_max = (latency > receiver->latency_ns_max) ? latency : receiver->latency_ns_max;
+}
+
+static void print_stats(struct dds_participant *participant)
+{
+    struct dds_stats stats;
+    dds_get_stats(participant, &stats);
+    printf("written %llu, datagrams sent %llu, delivered %llu, lost %llu, retransmitted %llu, nacks %llu, "
+           "dropped on purpose %llu\n",
+           (unsigned long long)stats.samples_written, (unsigned long long)stats.datagrams_sent,
+           (unsigned long long)stats.samples_delivered, (unsigned long long)stats.samples_lost,
+           (unsigned long long)stats.samples_retransmitted, (unsigned long long)stats.nacks_sent,
+           (unsigned long long)stats.datagrams_dropped);
+}
+
+int main(int argc, char *argv[])
+{
+    struct dds_config config = {NULL, 0U, "127.0.0.1", 0U, 0U, 0U};
+    struct dds_qos qos = {DDS_BEST_EFFORT, 0U, 0U};
+    unsigned long count = 10000;
+    unsigned long batch = 1;
+    unsigned long period_us = 100;
+    unsigned long seconds = 30;
+
+    if (argc < 3 || (strcmp(argv[1], "pub") != 0 && strcmp(argv[1], "sub") != 0))
+    {
+        fprintf(stderr, "Usage: %s pub|sub <topic> [--count n] [--batch n] [--period-us n] [--keep-last depth] "
+                        "[--history n] [--loss permille] [--flush-us n] [--seconds n]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 3; i + 1 < argc; i += 2)
+    {
+        unsigned long value = strtoul(argv[i + 1], NULL, 10);
+        if (strcmp(argv[i], "--count") == 0)
+        {
+            count = value;
+        }
+        else if (strcmp(argv[i], "--batch") == 0)
+        {
+            batch = (value > 0U && value <= 64U) ? value : 1U;
+        }
+        else if (strcmp(argv[i], "--period-us") == 0)
+        {
+            period_us = value;
+        }
+        else if (strcmp(argv[i], "--keep-last") == 0)
+        {
+            qos.reliability = DDS_KEEP_LAST;
+            qos.depth = (uint32_t)value;
+        }
+        else if (strcmp(argv[i], "--history") == 0)
+        {
+            qos.history = (uint32_t)value;
+        }
+        else if (strcmp(argv[i], "--loss") == 0)
+        {
+            config.loss_permille = (uint32_t)value;
+        }
+        else if (strcmp(argv[i], "--flush-us") == 0)
+        {
+            config.flush_us = (uint32_t)value;
+        }
+        else if (strcmp(argv[i], "--seconds") == 0)
+        {
+            seconds = value;
+        }
+    }
+
+    struct dds_participant *participant = dds_participant_create(&config);
+    if (NULL == participant)
+    {
+        return 1;
+    }
+
+    if (strcmp(argv[1], "sub") == 0)
+    {
+        struct loopback_receiver receiver;
+        memset(&receiver, 0, sizeof(receiver));
+        if (dds_create_reader(participant, argv[2], LOOPBACK_FINGERPRINT, sizeof(struct loopback_sample), &qos,
+                              on_sample, &receiver) < 0)
+        {
+            dds_participant_destroy(participant);
+            return 1;
+        }
+
+        /*---Polls the counters the receive thread updates; a stale read only delays the exit---*/
+        const uint64_t give_up = now_ns() + (uint64_t)seconds * 1000000000ULL;
+        while (now_ns() < give_up && (receiver.received == 0U || receiver.next_seq <= count))
+        {
+            sleep_us(10000);
+        }
+        print_stats(participant);
+        dds_participant_destroy(participant);
+
+        printf("received %llu of %lu, gaps %llu, latency avg %.1f us max %.1f us\n",
+               (unsigned long long)receiver.received, count, (unsigned long long)receiver.gaps,
+               receiver.received ? (double)receiver.latency_ns_total / (double)receiver.received / 1000.0 : 0.0,
+               (double)receiver.latency_ns_max / 1000.0);
+        return 0;
+    }
+
+    int writer = dds_create_writer(participant, argv[2], LOOPBACK_FINGERPRINT, sizeof(struct loopback_sample), &qos);
+    if (writer < 0)
+    {
+        dds_participant_destroy(participant);
+        return 1;
+    }
+    sleep_us(1000000UL); /*---discovery: let the subscribers announce themselves---*/
+
+    struct loopback_sample samples[64];
+    for (unsigned long seq = 1; seq <= count;)
+    {
+        unsigned long n = 0;
+        for (; n < batch && seq <= count; ++n, ++seq)
+        {
+            samples[n].seq = seq;
+            samples[n].sent_ns = now_ns();
+        }
+        dds_write(participant, writer, samples, n);
+        sleep_us(period_us);
+    }
+    sleep_us(500000UL); /*---stay around for the last repairs---*/
+    print_stats(participant);
+    dds_participant_destroy(participant);
+    return 0;
+}
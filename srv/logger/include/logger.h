@@ -29,16 +29,183 @@ typedef enum
     DEBUG_CRITICAL = 4
 } DEBUG_LOG_LEVEL;
 
-#define DEBUG_LOG(LEVEL, ...) dbg_log(__FILE__, __LINE__, __FUNCTION__, LEVEL, __VA_ARGS__)
+/*---Behaviour of the async logger when a thread's ring buffer is full---*/
+typedef enum
+{
+    LOG_OVERFLOW_DROP = 0,  /*---discard the new record and count it---*/
+    LOG_OVERFLOW_BLOCK = 1  /*---wait for the background thread to make room---*/
+} LOG_OVERFLOW_POLICY;
+
+/*---Clock used for log timestamps, both with nanosecond resolution---*/
+typedef enum
+{
+    LOG_CLOCK_REALTIME = 0,  /*---wall-clock date and time, comparable with SO_TIMESTAMPNS of CAN frames---*/
+    LOG_CLOCK_MONOTONIC = 1  /*---seconds since boot, never jumps---*/
+} LOG_CLOCK;
+
+/*
+ * Static description of one DEBUG_LOG call site. In binary mode only the site ID
+ * and the raw arguments are recorded, the site itself is written once per file.
+ */
+struct log_site
+{
+    const char *file;
+    int line;
+    const char *function;
+    const char *fmt;         /*---format literal, set on first binary use---*/
+    unsigned int id;         /*---binary log ID, assigned on first binary use---*/
+    unsigned int generation; /*---binary file the site was last described in---*/
+};
+
+/*
+ * Modules with their own runtime threshold. A translation unit selects its
+ * module by defining LOG_MODULE before including this header.
+ */
+typedef enum
+{
+    LOG_MODULE_DEFAULT = 0,
+    LOG_MODULE_CAN = 1,
+    LOG_MODULE_EXECUTION_MANAGER = 2,
+    LOG_MODULE_VEHICLE_MONITOR = 3,
+    LOG_MODULE_LOGGER = 4,
+    LOG_MODULE_USER = 8, /*---first ID free for application modules---*/
+    LOG_MAX_MODULES = 16
+} LOG_MODULE_ID;
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_DEFAULT
+#endif
+
+/*---Call sites below this level are removed at compile time, e.g. -DLOG_COMPILE_MIN_LEVEL=2---*/
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL DEBUG_TRACE
+#endif
+
+#if defined(__GNUC__)
+#define LOG_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define LOG_UNLIKELY(x) (x)
+#endif
+
+/*
+ * Lowest level any sink will accept per module: max(module threshold, min(active sink thresholds)).
+ * Maintained by the logger, read inline by DEBUG_LOG so a disabled statement costs one branch.
+ */
+extern unsigned char log_level_gate[LOG_MAX_MODULES];
 
-static FILE *log_file = NULL;
-static DEBUG_LOG_LEVEL console_log_threshold = DEBUG_INFO; /*---show on console---*/
-static DEBUG_LOG_LEVEL file_log_threshold = DEBUG_TRACE;   /*---write to file---*/
+#define DEBUG_LOG(LEVEL, ...)                                                                      \
+    do                                                                                             \
+    {                                                                                              \
+        if ((LEVEL) >= LOG_COMPILE_MIN_LEVEL && LOG_UNLIKELY((LEVEL) >= log_level_gate[LOG_MODULE])) \
+        {                                                                                          \
+            static struct log_site log_site_ = {__FILE__, __LINE__, __FUNCTION__, NULL, 0U, 0U};   \
+            dbg_log_site(&log_site_, LEVEL, __VA_ARGS__);                                          \
+        }                                                                                          \
+    } while (0)
 
+/*
+ * Per call site token bucket for DEBUG_LOG_RATELIMIT (GCRA, one atomic word).
+ * The first message let through after a suppressed run reports how many were dropped.
+ */
+struct log_ratelimit
+{
+    unsigned long long interval_ns;  /*---1 s / rate---*/
+    unsigned long long tolerance_ns; /*---(burst - 1) * interval---*/
+    unsigned long long tat_ns;       /*---theoretical arrival time of the next message---*/
+    unsigned int suppressed;
+};
+
+/*---Per call site counter for DEBUG_LOG_SAMPLED---*/
+struct log_sample
+{
+    unsigned int first;
+    unsigned int every;
+    unsigned long long count;
+};
+
+int log_ratelimit_allow(struct log_ratelimit *ratelimit, const struct log_site *site, DEBUG_LOG_LEVEL level);
+int log_sample_allow(struct log_sample *sample);
+
+/*---Like DEBUG_LOG, but at most RATE messages per second on average with bursts of up to BURST---*/
+#define DEBUG_LOG_RATELIMIT(LEVEL, RATE, BURST, ...)                                               \
+    do                                                                                             \
+    {                                                                                              \
+        if ((LEVEL) >= LOG_COMPILE_MIN_LEVEL && LOG_UNLIKELY((LEVEL) >= log_level_gate[LOG_MODULE])) \
+        {                                                                                          \
+            static struct log_site log_site_ = {__FILE__, __LINE__, __FUNCTION__, NULL, 0U, 0U};   \
+            static struct log_ratelimit log_ratelimit_ = {                                         \
+                1000000000ULL / (RATE), ((BURST) - 1ULL) * (1000000000ULL / (RATE)), 0ULL, 0U};    \
+            if (log_ratelimit_allow(&log_ratelimit_, &log_site_, LEVEL))                           \
+            {                                                                                      \
+                dbg_log_site(&log_site_, LEVEL, __VA_ARGS__);                                      \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+/*---Like DEBUG_LOG, but only the first FIRST_N occurrences and then every EVERY_M-th (0 = never again)---*/
+#define DEBUG_LOG_SAMPLED(LEVEL, FIRST_N, EVERY_M, ...)                                            \
+    do                                                                                             \
+    {                                                                                              \
+        if ((LEVEL) >= LOG_COMPILE_MIN_LEVEL && LOG_UNLIKELY((LEVEL) >= log_level_gate[LOG_MODULE])) \
+        {                                                                                          \
+            static struct log_site log_site_ = {__FILE__, __LINE__, __FUNCTION__, NULL, 0U, 0U};   \
+            static struct log_sample log_sample_ = {(FIRST_N), (EVERY_M), 0ULL};                   \
+            if (log_sample_allow(&log_sample_))                                                    \
+            {                                                                                      \
+                dbg_log_site(&log_site_, LEVEL, __VA_ARGS__);                                      \
+            }                                                                                      \
+        }                                                                                          \
+    } while (0)
+
+/*
+ * Text log file. Written through a preallocated memory mapped segment of
+ * segment_bytes that rotates as file -> file.1 -> ... when full, keeping at
+ * most segments files. Writeback of the mapping is started every sync_ms
+ * milliseconds (0 = only on rotation and close); with the async logger the
+ * worker also waits for it on the same interval, so a power loss costs at
+ * most the last interval. A process crash loses nothing. Limits apply to the
+ * next opened segment. If a segment cannot be created, lines are appended to
+ * the file without rotation. Defaults: 1 MiB x 4 segments, 1000 ms.
+ */
+void set_logger_file_limits(size_t segment_bytes, unsigned int segments, unsigned int sync_ms);
 void init_logger_file(const char *filename);
 void close_logger_file();
 void set_console_log_threshold(DEBUG_LOG_LEVEL level);
 void set_file_log_threshold(DEBUG_LOG_LEVEL level);
+void set_module_log_threshold(LOG_MODULE_ID module, DEBUG_LOG_LEVEL level);
+void set_log_timestamp_clock(LOG_CLOCK clock); /*---select before opening a binary log file---*/
+void set_log_dedup(int enable); /*---collapse identical consecutive messages, off by default (takes a global lock per line)---*/
 void dbg_log(const char *file, int line, const char *function, DEBUG_LOG_LEVEL level, const char *fmtstr, ...);
+void dbg_log_site(struct log_site *site, DEBUG_LOG_LEVEL level, const char *fmtstr, ...);
+
+/*
+ * Binary mode: records matching the file threshold are written to filename as
+ * (site ID, timestamp, raw argument bytes). Decode with the log_decode tool.
+ */
+void init_binary_logger_file(const char *filename);
+void close_binary_logger_file(void);
+
+/*
+ * Async mode: DEBUG_LOG only copies the record into a per-thread ring buffer,
+ * a background thread formats it and performs the I/O.
+ * ring_capacity is rounded up to a power of two. Returns 0 on success, -1 on failure.
+ * Pending records are flushed by stop_async_logger(), close_logger_file() and at exit.
+ */
+int start_async_logger(unsigned int ring_capacity, LOG_OVERFLOW_POLICY policy);
+void stop_async_logger(void);
+unsigned long long get_async_log_drops(void);
+
+/*
+ * Flight recorder: every DEBUG_LOG passing its module threshold is also kept, at
+ * any level and regardless of the sink thresholds, in a per-thread in-memory ring
+ * of entries_per_thread records (arguments stored raw, no formatting).
+ * On SIGSEGV, SIGBUS, SIGFPE, SIGILL and SIGABRT the rings are written to
+ * crash_path in the binary log format with async-signal-safe calls only, then the
+ * previous handler runs. dump_flight_recorder() writes the same on demand.
+ * Decode either file with log_decode. Return 0 on success, -1 on failure.
+ */
+int start_flight_recorder(unsigned int entries_per_thread, const char *crash_path);
+void stop_flight_recorder(void);
+int dump_flight_recorder(const char *path);
 
-#endif
\ No newline at end of file
+#endif
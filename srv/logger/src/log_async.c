@@ -0,0 +1,310 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "logger_internal.h"
+
+#define LOG_CACHE_LINE 64
+#define LOG_ASYNC_IDLE_SLEEP_NS 1000000L /*---background thread poll period when all rings are empty---*/
+
+/*
+ * Single producer (the owning thread) / single consumer (the background thread) ring.
+ * head and tail live on separate cache lines so producer and consumer do not false-share.
+ */
+struct log_ring
+{
+    _Alignas(LOG_CACHE_LINE) atomic_uint head; /*---next slot to write, owned by producer---*/
+    _Alignas(LOG_CACHE_LINE) atomic_uint tail; /*---next slot to read, owned by consumer---*/
+    _Alignas(LOG_CACHE_LINE) atomic_bool busy; /*---producer is between its enabled check and publish---*/
+    atomic_bool orphaned;                      /*---owning thread has exited---*/
+    unsigned int mask;
+    struct log_ring *next;
+    struct log_record slots[];
+};
+
+static pthread_mutex_t rings_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct log_ring *rings = NULL; /*---all live rings, new ones are pushed at the head---*/
+
+static pthread_t worker;
+static pthread_key_t ring_key;
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+static atomic_bool async_enabled = false;
+static atomic_bool worker_running = false;
+static atomic_ullong async_drops = 0;
+static unsigned int ring_capacity_slots = 0;
+static LOG_OVERFLOW_POLICY overflow_policy = LOG_OVERFLOW_DROP;
+static bool atexit_registered = false;
+
+static _Thread_local struct log_ring *tls_ring = NULL;
+
+static void ring_owner_exit(void *ring)
+{
+    // Freed by the background thread once drained
+    tls_ring = NULL;
+    atomic_store_explicit(&((struct log_ring *)ring)->orphaned, true, memory_order_release);
+}
+
+static void create_ring_key(void)
+{
+    pthread_key_create(&ring_key, ring_owner_exit);
+}
+
+static struct log_ring *get_thread_ring(void)
+{
+    if (tls_ring != NULL)
+    {
+        return tls_ring;
+    }
+
+    struct log_ring *ring = aligned_alloc(LOG_CACHE_LINE,
+                                          (sizeof(struct log_ring) + ring_capacity_slots * sizeof(struct log_record) +
+                                           LOG_CACHE_LINE - 1) & ~(size_t)(LOG_CACHE_LINE - 1));
+    if (ring == NULL)
+    {
+        return NULL;
+    }
+
+    atomic_init(&ring->head, 0U);
+    atomic_init(&ring->tail, 0U);
+    atomic_init(&ring->busy, false);
+    atomic_init(&ring->orphaned, false);
+    ring->mask = ring_capacity_slots - 1U;
+
+    pthread_once(&ring_key_once, create_ring_key);
+    pthread_setspecific(ring_key, ring);
+
+    pthread_mutex_lock(&rings_lock);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&rings_lock);
+
+    tls_ring = ring;
+    return ring;
+}
+
+int log_async_enqueue(struct log_site *site, const char *file, int line, const char *function, DEBUG_LOG_LEVEL level,
+                      const char *fmtstr, va_list args)
+{
+    struct log_ring *ring = tls_ring;
+
+    if (!atomic_load_explicit(&async_enabled, memory_order_relaxed))
+    {
+        return -1;
+    }
+    if (ring == NULL && (ring = get_thread_ring()) == NULL)
+    {
+        return -1;
+    }
+
+    // Pairs with stop_async_logger(): either it sees busy, or we see async_enabled == false
+    atomic_store(&ring->busy, true);
+    if (!atomic_load(&async_enabled))
+    {
+        atomic_store_explicit(&ring->busy, false, memory_order_release);
+        return -1;
+    }
+
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    while (head - atomic_load_explicit(&ring->tail, memory_order_acquire) > ring->mask)
+    {
+        if (overflow_policy == LOG_OVERFLOW_DROP)
+        {
+            atomic_fetch_add_explicit(&async_drops, 1ULL, memory_order_relaxed);
+            atomic_store_explicit(&ring->busy, false, memory_order_release);
+            return 0;
+        }
+        sched_yield();
+    }
+
+    log_fill_record(&ring->slots[head & ring->mask], site, file, line, function, level, fmtstr, args);
+
+    atomic_store_explicit(&ring->head, head + 1U, memory_order_release);
+    atomic_store_explicit(&ring->busy, false, memory_order_release);
+    return 0;
+}
+
+/*---Writes out everything currently queued on one ring, returns the number of records written---*/
+static unsigned int drain_ring(struct log_ring *ring)
+{
+    unsigned int tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    unsigned int count = head - tail;
+
+    while (tail != head)
+    {
+        log_write_record(&ring->slots[tail & ring->mask], false);
+        tail++;
+        // Release slots as we go so a blocked producer can continue
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+    return count;
+}
+
+/*---One pass over all rings; drained rings of exited threads are unlinked and freed---*/
+static unsigned int drain_all_rings(void)
+{
+    unsigned int written = 0;
+
+    pthread_mutex_lock(&rings_lock);
+    struct log_ring *ring = rings;
+    pthread_mutex_unlock(&rings_lock);
+
+    while (ring != NULL)
+    {
+        struct log_ring *next = ring->next;
+        bool orphaned = atomic_load_explicit(&ring->orphaned, memory_order_acquire);
+
+        written += drain_ring(ring);
+
+        if (orphaned)
+        {
+            pthread_mutex_lock(&rings_lock);
+            struct log_ring **link = &rings;
+            while (*link != NULL && *link != ring)
+            {
+                link = &(*link)->next;
+            }
+            if (*link == ring)
+            {
+                *link = ring->next;
+            }
+            pthread_mutex_unlock(&rings_lock);
+            free(ring);
+        }
+        ring = next;
+    }
+    return written;
+}
+
+static void *async_worker(void *arg)
+{
+    (void)arg;
+    bool dirty = false;
+
+    while (atomic_load_explicit(&worker_running, memory_order_acquire))
+    {
+        if (drain_all_rings() > 0U)
+        {
+            dirty = true;
+            continue;
+        }
+
+        // Flush once per idle period instead of once per line
+        if (dirty)
+        {
+            log_flush_sinks();
+            log_binary_flush();
+            dirty = false;
+        }
+
+        struct timespec idle = {0, LOG_ASYNC_IDLE_SLEEP_NS};
+        nanosleep(&idle, NULL);
+    }
+
+    // Final drain: no producer can publish anymore
+    drain_all_rings();
+    log_dedup_flush(true);
+    log_flush_sinks();
+    log_binary_flush();
+    return NULL;
+}
+
+int start_async_logger(unsigned int ring_capacity, LOG_OVERFLOW_POLICY policy)
+{
+    if (atomic_load(&worker_running))
+    {
+        return 0;
+    }
+    if (ring_capacity < 2U || ring_capacity > (1U << 20))
+    {
+        fprintf(stderr, "WARNING: Invalid async log ring capacity %u provided.\n", ring_capacity);
+        return -1;
+    }
+
+    // Rings of a previous session keep their size, only new threads see the new capacity
+    unsigned int capacity = 2U;
+    while (capacity < ring_capacity)
+    {
+        capacity <<= 1;
+    }
+    ring_capacity_slots = capacity;
+    overflow_policy = policy;
+
+    atomic_store(&worker_running, true);
+    if (pthread_create(&worker, NULL, async_worker, NULL) != 0)
+    {
+        atomic_store(&worker_running, false);
+        fprintf(stderr, "ERROR: Could not start async logger thread.\n");
+        return -1;
+    }
+    atomic_store(&async_enabled, true);
+
+    if (!atexit_registered)
+    {
+        atexit(stop_async_logger);
+        atexit_registered = true;
+    }
+    return 0;
+}
+
+void stop_async_logger(void)
+{
+    if (!atomic_load(&worker_running))
+    {
+        return;
+    }
+
+    // New DEBUG_LOG calls go synchronous from here on
+    atomic_store(&async_enabled, false);
+
+    // Wait for producers that passed the enabled check before it was cleared. The lock is only
+    // held for each scan: a producer blocked on a full ring needs the worker, and the worker
+    // needs rings_lock to start its next drain pass. Scanning under the lock also keeps the
+    // worker from freeing an orphaned ring while we look at it.
+    for (;;)
+    {
+        bool waiting = false;
+
+        pthread_mutex_lock(&rings_lock);
+        for (struct log_ring *ring = rings; ring != NULL && !waiting; ring = ring->next)
+        {
+            waiting = atomic_load(&ring->busy);
+        }
+        pthread_mutex_unlock(&rings_lock);
+
+        if (!waiting)
+        {
+            break;
+        }
+        sched_yield();
+    }
+
+    atomic_store_explicit(&worker_running, false, memory_order_release);
+    pthread_join(worker, NULL);
+}
+
+unsigned long long get_async_log_drops(void)
+{
+    return atomic_load_explicit(&async_drops, memory_order_relaxed);
+}
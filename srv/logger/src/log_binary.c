@@ -0,0 +1,223 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "logger_internal.h"
+#include "log_format.h"
+
+#define LOG_BIN_STDIO_BUFFER (64 * 1024)
+
+static FILE *binary_log_file = NULL;
+static pthread_mutex_t binary_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int binary_generation = 0; /*---bumped per opened file, sites re-register in each file---*/
+static unsigned int next_site_id = 1;
+
+static size_t put_bytes(uint8_t *buf, size_t pos, const void *data, size_t len)
+{
+    memcpy(buf + pos, data, len);
+    return pos + len;
+}
+
+static uint64_t timestamp_ns(const struct timespec *ts)
+{
+    return (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec;
+}
+
+static uint16_t clamp_len(const char *str, size_t max)
+{
+    size_t len = strlen(str);
+    return (uint16_t)(len > max ? max : len);
+}
+
+void init_binary_logger_file(const char *filename)
+{
+    pthread_mutex_lock(&binary_lock);
+    if (binary_log_file == NULL)
+    {
+        FILE *file = fopen(filename, "ab");
+        if (file == NULL)
+        {
+            fprintf(stderr, "ERROR: Could not open binary log file: %s\n", filename);
+        }
+        else
+        {
+            uint8_t header[LOG_BIN_MAGIC_LEN + 2 * sizeof(uint32_t)];
+            uint32_t endian = LOG_BIN_ENDIAN_MARK;
+            uint32_t clock = (uint32_t)log_timestamp_clock();
+
+            setvbuf(file, NULL, _IOFBF, LOG_BIN_STDIO_BUFFER);
+            memcpy(header, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN);
+            memcpy(header + LOG_BIN_MAGIC_LEN, &endian, sizeof(endian));
+            memcpy(header + LOG_BIN_MAGIC_LEN + sizeof(endian), &clock, sizeof(clock));
+            fwrite(header, 1, sizeof(header), file);
+
+            binary_generation++;
+            __atomic_store_n(&binary_log_file, file, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&binary_lock);
+    log_update_gates();
+}
+
+void close_binary_logger_file(void)
+{
+    // Drain queued records while the file is still open
+    stop_async_logger();
+    log_dedup_flush(true);
+
+    pthread_mutex_lock(&binary_lock);
+    if (binary_log_file != NULL)
+    {
+        FILE *file = binary_log_file;
+        __atomic_store_n(&binary_log_file, NULL, __ATOMIC_RELEASE);
+        fclose(file);
+    }
+    pthread_mutex_unlock(&binary_lock);
+    log_update_gates();
+}
+
+bool log_binary_active(void)
+{
+    return __atomic_load_n(&binary_log_file, __ATOMIC_RELAXED) != NULL;
+}
+
+int log_binary_register_site(struct log_site *site, const char *fmtstr)
+{
+    // Fast path: already described in the current file
+    if (__atomic_load_n(&site->generation, __ATOMIC_ACQUIRE) == __atomic_load_n(&binary_generation, __ATOMIC_RELAXED))
+    {
+        return 0;
+    }
+
+    int ret = -1;
+    pthread_mutex_lock(&binary_lock);
+    if (binary_log_file != NULL)
+    {
+        if (site->generation != binary_generation)
+        {
+            uint8_t buf[1 + 3 * sizeof(uint32_t) + 3 * 1024];
+            uint16_t file_len = clamp_len(site->file, 1024);
+            uint16_t func_len = clamp_len(site->function, 1024);
+            uint16_t fmt_len = clamp_len(fmtstr, 1024);
+            uint32_t line = (uint32_t)site->line;
+            uint32_t id = (site->id != 0U) ? site->id : next_site_id++;
+            size_t pos = 0;
+
+            buf[pos++] = LOG_BIN_SITE;
+            pos = put_bytes(buf, pos, &id, sizeof(id));
+            pos = put_bytes(buf, pos, &line, sizeof(line));
+            pos = put_bytes(buf, pos, &file_len, sizeof(file_len));
+            pos = put_bytes(buf, pos, &func_len, sizeof(func_len));
+            pos = put_bytes(buf, pos, &fmt_len, sizeof(fmt_len));
+            pos = put_bytes(buf, pos, site->file, file_len);
+            pos = put_bytes(buf, pos, site->function, func_len);
+            pos = put_bytes(buf, pos, fmtstr, fmt_len);
+            fwrite(buf, 1, pos, binary_log_file);
+
+            site->fmt = fmtstr;
+            site->id = id;
+            __atomic_store_n(&site->generation, binary_generation, __ATOMIC_RELEASE);
+        }
+        ret = 0;
+    }
+    pthread_mutex_unlock(&binary_lock);
+    return ret;
+}
+
+/*---Writes one encoded entry; the lock keeps close_binary_logger_file() from closing the file under us---*/
+static void write_entry(const uint8_t *buf, size_t len, bool flush)
+{
+    pthread_mutex_lock(&binary_lock);
+    if (binary_log_file != NULL)
+    {
+        // One fwrite per entry keeps entries from different threads intact
+        fwrite(buf, 1, len, binary_log_file);
+        if (flush)
+        {
+            fflush(binary_log_file);
+        }
+    }
+    pthread_mutex_unlock(&binary_lock);
+}
+
+void log_binary_write_record(const struct log_record *rec, bool flush)
+{
+    uint8_t buf[1 + sizeof(uint32_t) + 1 + sizeof(uint64_t) + sizeof(uint16_t) + LOG_RECORD_MSG_MAX];
+    uint32_t id = rec->site->id;
+    uint64_t ts = timestamp_ns(&rec->timestamp);
+    uint16_t args_len = (uint16_t)rec->msg_len;
+    size_t pos = 0;
+
+    // Cheap early out, write_entry() checks again under the lock
+    if (!log_binary_active())
+    {
+        return;
+    }
+
+    buf[pos++] = LOG_BIN_RECORD;
+    pos = put_bytes(buf, pos, &id, sizeof(id));
+    buf[pos++] = (uint8_t)rec->level;
+    pos = put_bytes(buf, pos, &ts, sizeof(ts));
+    pos = put_bytes(buf, pos, &args_len, sizeof(args_len));
+    pos = put_bytes(buf, pos, rec->msg, args_len);
+
+    write_entry(buf, pos, flush && rec->level >= DEBUG_ERROR);
+}
+
+void log_binary_write_text(const struct log_record *rec, bool flush)
+{
+    uint8_t buf[1 + 1 + sizeof(uint64_t) + sizeof(uint32_t) + 3 * sizeof(uint16_t) + 2 * 256 + LOG_RECORD_MSG_MAX];
+    uint64_t ts = timestamp_ns(&rec->timestamp);
+    uint32_t line = (uint32_t)rec->line;
+    uint16_t file_len = clamp_len(rec->file, 256);
+    uint16_t func_len = clamp_len(rec->function, 256);
+    uint16_t msg_len = (uint16_t)rec->msg_len;
+    size_t pos = 0;
+
+    // Cheap early out, write_entry() checks again under the lock
+    if (!log_binary_active())
+    {
+        return;
+    }
+
+    buf[pos++] = LOG_BIN_TEXT;
+    buf[pos++] = (uint8_t)rec->level;
+    pos = put_bytes(buf, pos, &ts, sizeof(ts));
+    pos = put_bytes(buf, pos, &line, sizeof(line));
+    pos = put_bytes(buf, pos, &file_len, sizeof(file_len));
+    pos = put_bytes(buf, pos, &func_len, sizeof(func_len));
+    pos = put_bytes(buf, pos, &msg_len, sizeof(msg_len));
+    pos = put_bytes(buf, pos, rec->file, file_len);
+    pos = put_bytes(buf, pos, rec->function, func_len);
+    pos = put_bytes(buf, pos, rec->msg, msg_len);
+
+    write_entry(buf, pos, flush && rec->level >= DEBUG_ERROR);
+}
+
+void log_binary_flush(void)
+{
+    pthread_mutex_lock(&binary_lock);
+    if (binary_log_file != NULL)
+    {
+        fflush(binary_log_file);
+    }
+    pthread_mutex_unlock(&binary_lock);
+}
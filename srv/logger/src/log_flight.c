@@ -0,0 +1,474 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "logger_internal.h"
+#include "log_format.h"
+
+#define LOG_FLIGHT_MAX_ENTRIES (1U << 16)
+#define LOG_FLIGHT_ALTSTACK_SIZE (64 * 1024)
+#define LOG_FLIGHT_DUMP_BUFFER 4096
+#define LOG_FLIGHT_SITE_CACHE 256U /*---site -> dump ID slots, power of two---*/
+#define LOG_FLIGHT_NAME_MAX 1024U
+
+/*
+ * Per-entry seqlock: odd while the owner rewrites the entry, 2 * index + 2 once
+ * entry index is complete. A dump that races the owner skips torn entries.
+ */
+struct flight_entry
+{
+    atomic_ullong seq;
+    struct log_record rec;
+};
+
+/*
+ * One ring per thread, written by its owner only. Rings are never freed: a
+ * ring whose thread exited is handed to the next new thread with its history.
+ */
+struct flight_ring
+{
+    struct flight_ring *next; /*---immutable once pushed---*/
+    atomic_bool in_use;
+    atomic_ullong head;       /*---entries ever written---*/
+    unsigned long long dump_pos;
+    unsigned long long dump_end;
+    unsigned int mask;
+    struct flight_entry entries[];
+};
+
+static struct flight_ring *_Atomic flight_rings = NULL;
+static _Thread_local struct flight_ring *tls_flight = NULL;
+static pthread_key_t flight_key;
+static pthread_once_t flight_key_once = PTHREAD_ONCE_INIT;
+static atomic_bool flight_enabled = false;
+static atomic_flag dump_in_progress = ATOMIC_FLAG_INIT;
+static unsigned int flight_capacity = 0;
+static char crash_dump_path[PATH_MAX];
+
+static const int crash_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+#define NUM_CRASH_SIGNALS (sizeof(crash_signals) / sizeof(crash_signals[0]))
+static struct sigaction previous_actions[NUM_CRASH_SIGNALS];
+static bool handlers_installed = false;
+static char altstack[LOG_FLIGHT_ALTSTACK_SIZE];
+
+static void flight_owner_exit(void *ring)
+{
+    tls_flight = NULL;
+    atomic_store_explicit(&((struct flight_ring *)ring)->in_use, false, memory_order_release);
+}
+
+static void create_flight_key(void)
+{
+    pthread_key_create(&flight_key, flight_owner_exit);
+}
+
+static struct flight_ring *get_flight_ring(void)
+{
+    struct flight_ring *ring;
+
+    // Adopt the ring of an exited thread before allocating
+    for (ring = atomic_load(&flight_rings); ring != NULL; ring = ring->next)
+    {
+        bool expected = false;
+        if (ring->mask == flight_capacity - 1U && atomic_compare_exchange_strong(&ring->in_use, &expected, true))
+        {
+            break;
+        }
+    }
+
+    if (ring == NULL)
+    {
+        ring = calloc(1, sizeof(*ring) + flight_capacity * sizeof(struct flight_entry));
+        if (ring == NULL)
+        {
+            return NULL;
+        }
+        atomic_init(&ring->in_use, true);
+        atomic_init(&ring->head, 0ULL);
+        ring->mask = flight_capacity - 1U;
+
+        ring->next = atomic_load(&flight_rings);
+        while (!atomic_compare_exchange_weak(&flight_rings, &ring->next, ring))
+        {
+        }
+    }
+
+    pthread_once(&flight_key_once, create_flight_key);
+    pthread_setspecific(flight_key, ring);
+    tls_flight = ring;
+    return ring;
+}
+
+bool log_flight_active(void)
+{
+    return atomic_load_explicit(&flight_enabled, memory_order_relaxed);
+}
+
+void log_flight_record(struct log_site *site, const char *file, int line, const char *function, DEBUG_LOG_LEVEL level,
+                       const char *fmtstr, va_list args)
+{
+    struct flight_ring *ring = tls_flight;
+
+    if (ring == NULL && (ring = get_flight_ring()) == NULL)
+    {
+        return;
+    }
+
+    unsigned long long index = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    struct flight_entry *entry = &ring->entries[index & ring->mask];
+    struct log_record *rec = &entry->rec;
+
+    atomic_store_explicit(&entry->seq, 2ULL * index + 1ULL, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    clock_gettime((log_timestamp_clock() == LOG_TS_MONOTONIC) ? CLOCK_MONOTONIC : CLOCK_REALTIME, &rec->timestamp);
+    rec->clock = log_timestamp_clock();
+    rec->file = file;
+    rec->line = line;
+    rec->function = function;
+    rec->level = level;
+
+    if (site != NULL)
+    {
+        // Raw arguments only, the dump is rendered offline by log_decode
+        if (site->fmt == NULL)
+        {
+            __atomic_store_n(&site->fmt, fmtstr, __ATOMIC_RELAXED);
+        }
+        rec->site = site;
+        rec->msg_len = log_bin_encode_args((uint8_t *)rec->msg, sizeof(rec->msg), fmtstr, args);
+    }
+    else
+    {
+        va_list args_copy;
+        va_copy(args_copy, args);
+        int len = vsnprintf(rec->msg, sizeof(rec->msg), fmtstr, args_copy);
+        va_end(args_copy);
+        rec->site = NULL;
+        rec->msg_len = (len < 0) ? 0U : ((size_t)len >= sizeof(rec->msg) ? sizeof(rec->msg) - 1 : (unsigned int)len);
+    }
+
+    atomic_store_explicit(&entry->seq, 2ULL * index + 2ULL, memory_order_release);
+    atomic_store_explicit(&ring->head, index + 1ULL, memory_order_release);
+}
+
+/*---Dump writer: only write(), strlen() and memcpy(), so it may run in a signal handler---*/
+struct dump_writer
+{
+    int fd;
+    size_t len;
+    bool failed;
+    uint8_t buf[LOG_FLIGHT_DUMP_BUFFER];
+};
+
+static void dump_flush(struct dump_writer *w)
+{
+    size_t done = 0;
+    while (done < w->len && !w->failed)
+    {
+        ssize_t n = write(w->fd, w->buf + done, w->len - done);
+        if (n < 0 && errno != EINTR)
+        {
+            w->failed = true;
+        }
+        else if (n > 0)
+        {
+            done += (size_t)n;
+        }
+    }
+    w->len = 0;
+}
+
+static void dump_put(struct dump_writer *w, const void *data, size_t len)
+{
+    const uint8_t *src = data;
+    while (len > 0U)
+    {
+        size_t chunk = sizeof(w->buf) - w->len;
+        if (chunk > len)
+        {
+            chunk = len;
+        }
+        memcpy(w->buf + w->len, src, chunk);
+        w->len += chunk;
+        src += chunk;
+        len -= chunk;
+        if (w->len == sizeof(w->buf))
+        {
+            dump_flush(w);
+        }
+    }
+}
+
+static uint16_t dump_strlen(const char *str)
+{
+    size_t len = (str != NULL) ? strlen(str) : 0U;
+    return (uint16_t)(len > LOG_FLIGHT_NAME_MAX ? LOG_FLIGHT_NAME_MAX : len);
+}
+
+static void dump_site(struct dump_writer *w, const struct log_site *site, uint32_t id)
+{
+    uint8_t type = LOG_BIN_SITE;
+    uint32_t line = (uint32_t)site->line;
+    uint16_t file_len = dump_strlen(site->file);
+    uint16_t func_len = dump_strlen(site->function);
+    uint16_t fmt_len = dump_strlen(site->fmt);
+
+    dump_put(w, &type, sizeof(type));
+    dump_put(w, &id, sizeof(id));
+    dump_put(w, &line, sizeof(line));
+    dump_put(w, &file_len, sizeof(file_len));
+    dump_put(w, &func_len, sizeof(func_len));
+    dump_put(w, &fmt_len, sizeof(fmt_len));
+    dump_put(w, site->file, file_len);
+    dump_put(w, site->function, func_len);
+    dump_put(w, site->fmt, fmt_len);
+}
+
+static void dump_entry(struct dump_writer *w, const struct log_record *rec, const struct log_site **site_cache,
+                       uint32_t *next_id)
+{
+    uint64_t ns = (uint64_t)rec->timestamp.tv_sec * 1000000000ULL + (uint64_t)rec->timestamp.tv_nsec;
+    uint8_t level = (uint8_t)rec->level;
+    uint8_t type;
+
+    if (rec->site != NULL && rec->site->fmt != NULL)
+    {
+        // Site IDs are local to the dump: slot index + 1, a colliding site is described again
+        uintptr_t hash = ((uintptr_t)rec->site >> 4) & (LOG_FLIGHT_SITE_CACHE - 1U);
+        uint32_t id = (uint32_t)hash + 1U;
+        uint16_t args_len = (uint16_t)rec->msg_len;
+
+        if (site_cache[hash] != rec->site)
+        {
+            if (site_cache[hash] != NULL)
+            {
+                id = (*next_id)++;
+            }
+            else
+            {
+                site_cache[hash] = rec->site;
+            }
+            dump_site(w, rec->site, id);
+        }
+
+        type = LOG_BIN_RECORD;
+        dump_put(w, &type, sizeof(type));
+        dump_put(w, &id, sizeof(id));
+        dump_put(w, &level, sizeof(level));
+        dump_put(w, &ns, sizeof(ns));
+        dump_put(w, &args_len, sizeof(args_len));
+        dump_put(w, rec->msg, args_len);
+    }
+    else
+    {
+        uint32_t line = (uint32_t)rec->line;
+        uint16_t file_len = dump_strlen(rec->file);
+        uint16_t func_len = dump_strlen(rec->function);
+        uint16_t msg_len = (uint16_t)rec->msg_len;
+
+        type = LOG_BIN_TEXT;
+        dump_put(w, &type, sizeof(type));
+        dump_put(w, &level, sizeof(level));
+        dump_put(w, &ns, sizeof(ns));
+        dump_put(w, &line, sizeof(line));
+        dump_put(w, &file_len, sizeof(file_len));
+        dump_put(w, &func_len, sizeof(func_len));
+        dump_put(w, &msg_len, sizeof(msg_len));
+        dump_put(w, rec->file, file_len);
+        dump_put(w, rec->function, func_len);
+        dump_put(w, rec->msg, msg_len);
+    }
+}
+
+/*---Copies entry index of ring into out, false if it was overwritten or is being written---*/
+static bool read_entry(struct flight_ring *ring, unsigned long long index, struct log_record *out)
+{
+    struct flight_entry *entry = &ring->entries[index & ring->mask];
+    unsigned long long seq = atomic_load_explicit(&entry->seq, memory_order_acquire);
+
+    if (seq != 2ULL * index + 2ULL)
+    {
+        return false;
+    }
+    memcpy(out, &entry->rec, sizeof(*out));
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&entry->seq, memory_order_relaxed) == seq;
+}
+
+static int dump_to_fd(int fd)
+{
+    struct dump_writer w = {fd, 0U, false, {0}};
+    const struct log_site *site_cache[LOG_FLIGHT_SITE_CACHE] = {NULL};
+    uint32_t next_id = LOG_FLIGHT_SITE_CACHE + 1U;
+    uint32_t endian = LOG_BIN_ENDIAN_MARK;
+    uint32_t clock = (uint32_t)log_timestamp_clock();
+    struct log_record rec;
+
+    dump_put(&w, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN);
+    dump_put(&w, &endian, sizeof(endian));
+    dump_put(&w, &clock, sizeof(clock));
+
+    for (struct flight_ring *ring = atomic_load(&flight_rings); ring != NULL; ring = ring->next)
+    {
+        ring->dump_end = atomic_load_explicit(&ring->head, memory_order_acquire);
+        ring->dump_pos = (ring->dump_end > ring->mask + 1ULL) ? ring->dump_end - ring->mask - 1ULL : 0ULL;
+    }
+
+    // Merge the rings by timestamp so the dump reads as one timeline
+    for (;;)
+    {
+        struct flight_ring *oldest = NULL;
+        struct timespec oldest_ts = {0, 0};
+
+        for (struct flight_ring *ring = atomic_load(&flight_rings); ring != NULL; ring = ring->next)
+        {
+            // Skip entries the owner overwrote since the snapshot
+            while (ring->dump_pos < ring->dump_end && !read_entry(ring, ring->dump_pos, &rec))
+            {
+                ring->dump_pos++;
+            }
+            if (ring->dump_pos < ring->dump_end &&
+                (oldest == NULL || rec.timestamp.tv_sec < oldest_ts.tv_sec ||
+                 (rec.timestamp.tv_sec == oldest_ts.tv_sec && rec.timestamp.tv_nsec < oldest_ts.tv_nsec)))
+            {
+                oldest = ring;
+                oldest_ts = rec.timestamp;
+            }
+        }
+        if (oldest == NULL)
+        {
+            break;
+        }
+        if (read_entry(oldest, oldest->dump_pos, &rec))
+        {
+            dump_entry(&w, &rec, site_cache, &next_id);
+        }
+        oldest->dump_pos++;
+    }
+
+    dump_flush(&w);
+    return w.failed ? -1 : 0;
+}
+
+static int dump_to_path(const char *path)
+{
+    int ret = -1;
+
+    if (atomic_flag_test_and_set(&dump_in_progress))
+    {
+        return -1;
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd >= 0)
+    {
+        ret = dump_to_fd(fd);
+        fsync(fd);
+        close(fd);
+    }
+    atomic_flag_clear(&dump_in_progress);
+    return ret;
+}
+
+static void flight_crash_handler(int sig)
+{
+    dump_to_path(crash_dump_path);
+
+    // Hand the signal to whoever was installed before us (default: terminate with core)
+    for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i)
+    {
+        if (crash_signals[i] == sig)
+        {
+            sigaction(sig, &previous_actions[i], NULL);
+        }
+    }
+    raise(sig);
+}
+
+int start_flight_recorder(unsigned int entries_per_thread, const char *crash_path)
+{
+    if (entries_per_thread < 2U || entries_per_thread > LOG_FLIGHT_MAX_ENTRIES || crash_path == NULL ||
+        strlen(crash_path) >= sizeof(crash_dump_path))
+    {
+        fprintf(stderr, "WARNING: Invalid flight recorder configuration provided.\n");
+        return -1;
+    }
+
+    unsigned int capacity = 2U;
+    while (capacity < entries_per_thread)
+    {
+        capacity <<= 1;
+    }
+    flight_capacity = capacity;
+    memcpy(crash_dump_path, crash_path, strlen(crash_path) + 1U);
+
+    if (!handlers_installed)
+    {
+        // Alternate stack for the calling thread so a stack overflow can still be dumped
+        stack_t ss;
+        ss.ss_sp = altstack;
+        ss.ss_size = sizeof(altstack);
+        ss.ss_flags = 0;
+        sigaltstack(&ss, NULL);
+
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = flight_crash_handler;
+        sa.sa_flags = SA_ONSTACK;
+        sigemptyset(&sa.sa_mask);
+        for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i)
+        {
+            sigaction(crash_signals[i], &sa, &previous_actions[i]);
+        }
+        handlers_installed = true;
+    }
+
+    atomic_store(&flight_enabled, true);
+    log_update_gates();
+    return 0;
+}
+
+void stop_flight_recorder(void)
+{
+    atomic_store(&flight_enabled, false);
+    if (handlers_installed)
+    {
+        for (size_t i = 0; i < NUM_CRASH_SIGNALS; ++i)
+        {
+            sigaction(crash_signals[i], &previous_actions[i], NULL);
+        }
+        handlers_installed = false;
+    }
+    log_update_gates();
+}
+
+int dump_flight_recorder(const char *path)
+{
+    return dump_to_path(path);
+}
@@ -0,0 +1,478 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "log_format.h"
+
+#define LOG_BIN_STRING_MAX 255U /*---longest %s argument kept in a binary record---*/
+
+enum length_modifier
+{
+    LEN_NONE,
+    LEN_HH,
+    LEN_H,
+    LEN_L,
+    LEN_LL,
+    LEN_J,
+    LEN_Z,
+    LEN_T,
+    LEN_BIG_L
+};
+
+/*---One parsed conversion specification, start points at the '%'---*/
+struct fmt_spec
+{
+    const char *start;
+    const char *length_start; /*---first char of the length modifier (or the conversion)---*/
+    enum length_modifier length;
+    bool star_width;
+    bool star_precision;
+    char conversion;
+};
+
+/*---Parses the specification following a '%', returns a pointer past the conversion character---*/
+static const char *parse_spec(const char *p, struct fmt_spec *spec)
+{
+    spec->start = p - 1;
+    spec->star_width = false;
+    spec->star_precision = false;
+    spec->length = LEN_NONE;
+
+    while (*p != '\0' && strchr("-+ #0'I", *p) != NULL)
+    {
+        p++;
+    }
+    if (*p == '*')
+    {
+        spec->star_width = true;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        p++;
+    }
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            spec->star_precision = true;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+
+    spec->length_start = p;
+    switch (*p)
+    {
+    case 'h':
+        spec->length = (p[1] == 'h') ? LEN_HH : LEN_H;
+        p += (p[1] == 'h') ? 2 : 1;
+        break;
+    case 'l':
+        spec->length = (p[1] == 'l') ? LEN_LL : LEN_L;
+        p += (p[1] == 'l') ? 2 : 1;
+        break;
+    case 'q':
+        spec->length = LEN_LL;
+        p++;
+        break;
+    case 'L':
+        spec->length = LEN_BIG_L;
+        p++;
+        break;
+    case 'j':
+        spec->length = LEN_J;
+        p++;
+        break;
+    case 'z':
+        spec->length = LEN_Z;
+        p++;
+        break;
+    case 't':
+        spec->length = LEN_T;
+        p++;
+        break;
+    default:
+        break;
+    }
+
+    spec->conversion = *p;
+    return (*p != '\0') ? p + 1 : p;
+}
+
+size_t log_format_prefix(char *out, size_t size, const struct timespec *ts, int clock, const char *file, int line,
+                         const char *function, int level)
+{
+    /*---Per-thread cache of the "YYYY-MM-DD HH:MM:SS" text, localtime_r() runs once per second---*/
+    static _Thread_local time_t cached_sec = (time_t)-1;
+    static _Thread_local char cached_text[32];
+    int len;
+
+    if (clock == LOG_TS_MONOTONIC)
+    {
+        len = snprintf(out, size, "[%lld.%06ld] [%s:%d] %s() [Level:%d]: ", (long long)ts->tv_sec,
+                       ts->tv_nsec / 1000L, file, line, function, level);
+    }
+    else
+    {
+        if (ts->tv_sec != cached_sec)
+        {
+            struct tm local_time_info;
+            localtime_r(&ts->tv_sec, &local_time_info);
+            strftime(cached_text, sizeof(cached_text), "%Y-%m-%d %H:%M:%S", &local_time_info);
+            cached_sec = ts->tv_sec;
+        }
+        len = snprintf(out, size, "[%s.%06ld] [%s:%d] %s() [Level:%d]: ", cached_text, ts->tv_nsec / 1000L,
+                       file, line, function, level);
+    }
+
+    if (len < 0)
+    {
+        out[0] = '\0';
+        return 0;
+    }
+    return ((size_t)len >= size) ? size - 1 : (size_t)len;
+}
+
+static bool put_u64(uint8_t *out, unsigned int size, unsigned int *pos, uint64_t value)
+{
+    if (*pos + sizeof(value) > size)
+    {
+        return false;
+    }
+    memcpy(out + *pos, &value, sizeof(value));
+    *pos += sizeof(value);
+    return true;
+}
+
+static bool get_u64(const uint8_t *args, unsigned int args_len, unsigned int *pos, uint64_t *value)
+{
+    if (*pos + sizeof(*value) > args_len)
+    {
+        return false;
+    }
+    memcpy(value, args + *pos, sizeof(*value));
+    *pos += sizeof(*value);
+    return true;
+}
+
+static int64_t va_arg_signed(va_list *args, enum length_modifier length)
+{
+    switch (length)
+    {
+    case LEN_L:
+        return va_arg(*args, long);
+    case LEN_LL:
+        return va_arg(*args, long long);
+    case LEN_J:
+        return va_arg(*args, intmax_t);
+    case LEN_Z:
+        return va_arg(*args, ssize_t);
+    case LEN_T:
+        return va_arg(*args, ptrdiff_t);
+    default:
+        return va_arg(*args, int);
+    }
+}
+
+static uint64_t va_arg_unsigned(va_list *args, enum length_modifier length)
+{
+    switch (length)
+    {
+    case LEN_L:
+        return va_arg(*args, unsigned long);
+    case LEN_LL:
+        return va_arg(*args, unsigned long long);
+    case LEN_J:
+        return va_arg(*args, uintmax_t);
+    case LEN_Z:
+        return va_arg(*args, size_t);
+    case LEN_T:
+        return (uint64_t)va_arg(*args, ptrdiff_t);
+    default:
+        return va_arg(*args, unsigned int);
+    }
+}
+
+unsigned int log_bin_encode_args(uint8_t *out, unsigned int size, const char *fmt, va_list args)
+{
+    unsigned int pos = 0;
+    struct fmt_spec spec;
+    va_list ap;
+
+    va_copy(ap, args);
+    for (const char *p = fmt; *p != '\0';)
+    {
+        if (*p++ != '%')
+        {
+            continue;
+        }
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+
+        if (spec.star_width && !put_u64(out, size, &pos, (uint64_t)(int64_t)va_arg(ap, int)))
+        {
+            break;
+        }
+        if (spec.star_precision && !put_u64(out, size, &pos, (uint64_t)(int64_t)va_arg(ap, int)))
+        {
+            break;
+        }
+
+        bool fits = true;
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+        case 'c':
+            fits = put_u64(out, size, &pos, (uint64_t)va_arg_signed(&ap, spec.length));
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            fits = put_u64(out, size, &pos, va_arg_unsigned(&ap, spec.length));
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            double d = (spec.length == LEN_BIG_L) ? (double)va_arg(ap, long double) : va_arg(ap, double);
+            uint64_t bits;
+            memcpy(&bits, &d, sizeof(bits));
+            fits = put_u64(out, size, &pos, bits);
+            break;
+        }
+        case 'p':
+            fits = put_u64(out, size, &pos, (uint64_t)(uintptr_t)va_arg(ap, void *));
+            break;
+        case 's':
+        {
+            const char *str = va_arg(ap, const char *);
+            size_t len;
+            if (str == NULL)
+            {
+                str = "(null)";
+            }
+            len = strnlen(str, LOG_BIN_STRING_MAX);
+            if (pos + 1U + len > size)
+            {
+                fits = false;
+                break;
+            }
+            out[pos++] = (uint8_t)len;
+            memcpy(out + pos, str, len);
+            pos += (unsigned int)len;
+            break;
+        }
+        case 'n':
+            (void)va_arg(ap, void *);
+            break;
+        default:
+            // Unknown conversion, argument types after it cannot be known
+            fits = false;
+            break;
+        }
+
+        if (!fits)
+        {
+            break;
+        }
+    }
+    va_end(ap);
+    return pos;
+}
+
+/*---Copies the spec up to its length modifier with '*' replaced by the recorded values---*/
+static size_t build_spec(char *out, size_t size, const struct fmt_spec *spec, int64_t width, int64_t precision)
+{
+    size_t len = 0;
+    bool seen_dot = false;
+
+    for (const char *q = spec->start; q < spec->length_start && len + 24 < size; ++q)
+    {
+        if (*q == '.')
+        {
+            seen_dot = true;
+        }
+        if (*q == '*')
+        {
+            len += (size_t)snprintf(out + len, size - len, "%lld", (long long)(seen_dot ? precision : width));
+        }
+        else
+        {
+            out[len++] = *q;
+        }
+    }
+    out[len] = '\0';
+    return len;
+}
+
+size_t log_bin_render(char *out, size_t size, const char *fmt, const uint8_t *args, unsigned int args_len)
+{
+    size_t len = 0;
+    unsigned int pos = 0;
+    struct fmt_spec spec;
+    char spec_buf[64];
+
+    if (size == 0U)
+    {
+        return 0;
+    }
+
+    for (const char *p = fmt; *p != '\0' && len + 1 < size;)
+    {
+        if (*p != '%')
+        {
+            out[len++] = *p++;
+            continue;
+        }
+        p++;
+        if (*p == '%')
+        {
+            out[len++] = '%';
+            p++;
+            continue;
+        }
+
+        p = parse_spec(p, &spec);
+
+        uint64_t width = 0;
+        uint64_t precision = 0;
+        uint64_t value = 0;
+        bool ok = true;
+        if (spec.star_width)
+        {
+            ok = get_u64(args, args_len, &pos, &width);
+        }
+        if (ok && spec.star_precision)
+        {
+            ok = get_u64(args, args_len, &pos, &precision);
+        }
+
+        size_t spec_len = build_spec(spec_buf, sizeof(spec_buf) - 4, &spec, (int64_t)width, (int64_t)precision);
+        int written = 0;
+
+        switch (spec.conversion)
+        {
+        case 'd':
+        case 'i':
+        {
+            ok = ok && get_u64(args, args_len, &pos, &value);
+            int64_t v = (int64_t)value;
+            v = (spec.length == LEN_HH) ? (signed char)v : ((spec.length == LEN_H) ? (short)v : v);
+            memcpy(spec_buf + spec_len, "lld", 4);
+            written = ok ? snprintf(out + len, size - len, spec_buf, (long long)v) : 0;
+            break;
+        }
+        case 'c':
+            ok = ok && get_u64(args, args_len, &pos, &value);
+            memcpy(spec_buf + spec_len, "c", 2);
+            written = ok ? snprintf(out + len, size - len, spec_buf, (int)value) : 0;
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            ok = ok && get_u64(args, args_len, &pos, &value);
+            value = (spec.length == LEN_HH) ? (unsigned char)value : ((spec.length == LEN_H) ? (unsigned short)value : value);
+            spec_buf[spec_len] = 'l';
+            spec_buf[spec_len + 1] = 'l';
+            spec_buf[spec_len + 2] = spec.conversion;
+            spec_buf[spec_len + 3] = '\0';
+            written = ok ? snprintf(out + len, size - len, spec_buf, (unsigned long long)value) : 0;
+            break;
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+        {
+            double d;
+            ok = ok && get_u64(args, args_len, &pos, &value);
+            memcpy(&d, &value, sizeof(d));
+            spec_buf[spec_len] = spec.conversion;
+            spec_buf[spec_len + 1] = '\0';
+            written = ok ? snprintf(out + len, size - len, spec_buf, d) : 0;
+            break;
+        }
+        case 'p':
+            ok = ok && get_u64(args, args_len, &pos, &value);
+            memcpy(spec_buf + spec_len, "p", 2);
+            written = ok ? snprintf(out + len, size - len, spec_buf, (void *)(uintptr_t)value) : 0;
+            break;
+        case 's':
+        {
+            char str[LOG_BIN_STRING_MAX + 1];
+            unsigned int str_len = (ok && pos < args_len) ? args[pos] : 0U;
+            ok = ok && pos + 1U + str_len <= args_len;
+            if (ok)
+            {
+                memcpy(str, args + pos + 1, str_len);
+                str[str_len] = '\0';
+                pos += 1U + str_len;
+            }
+            memcpy(spec_buf + spec_len, "s", 2);
+            written = ok ? snprintf(out + len, size - len, spec_buf, str) : 0;
+            break;
+        }
+        case 'n':
+            break;
+        default:
+            ok = false;
+            break;
+        }
+
+        if (!ok)
+        {
+            // Arguments ran out: the record was truncated at capture time
+            written = snprintf(out + len, size - len, "%s", LOG_BIN_TRUNCATED_MARK);
+            len += (written > 0) ? (size_t)written : 0U;
+            break;
+        }
+        len += (written > 0) ? (size_t)written : 0U;
+    }
+
+    if (len >= size)
+    {
+        len = size - 1;
+    }
+    out[len] = '\0';
+    return len;
+}
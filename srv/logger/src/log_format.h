@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOG_FORMAT_H
+#define LOG_FORMAT_H
+
+/*
+ * Formatting helpers and binary log codec. Shared by the logger library and
+ * the host side decoder (tools/log_decode.c), so both render identical text.
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/*---Binary log file layout, all fields in host byte order---*/
+#define LOG_BIN_MAGIC "OSAPBLG1"
+#define LOG_BIN_MAGIC_LEN 8
+#define LOG_BIN_ENDIAN_MARK 0x01020304U
+
+/*
+ * File header: magic[8], u32 endian mark, u32 clock (LOG_TS_REALTIME / LOG_TS_MONOTONIC).
+ * Records start with a u8 type:
+ *   LOG_BIN_SITE   u32 id, u32 line, u16 file_len, u16 func_len, u16 fmt_len, file, func, fmt
+ *   LOG_BIN_RECORD u32 site id, u8 level, u64 timestamp ns, u16 args_len, args
+ *   LOG_BIN_TEXT   u8 level, u64 timestamp ns, u32 line, u16 file_len, u16 func_len, u16 msg_len, file, func, msg
+ */
+enum
+{
+    LOG_BIN_SITE = 1,
+    LOG_BIN_RECORD = 2,
+    LOG_BIN_TEXT = 3
+};
+
+/*---Clock a timestamp was taken from---*/
+enum
+{
+    LOG_TS_REALTIME = 0,  /*---rendered as local wall-clock date and time---*/
+    LOG_TS_MONOTONIC = 1  /*---rendered as seconds since boot---*/
+};
+
+/*---Arguments that did not fit the record are cut off; render appends this marker---*/
+#define LOG_BIN_TRUNCATED_MARK "..."
+
+/**
+ * @brief Formats the "[timestamp] [file:line] func() [Level:n]: " prefix.
+ *
+ * Timestamps carry microseconds. The wall-clock date/time text is cached per
+ * thread and only rebuilt when the second changes.
+ *
+ * @return Length written (excluding the terminating NUL), clamped to size - 1.
+ */
+size_t log_format_prefix(char *out, size_t size, const struct timespec *ts, int clock, const char *file, int line,
+                         const char *function, int level);
+
+/**
+ * @brief Serializes the printf arguments described by fmt as raw bytes.
+ *
+ * Integers, pointers and doubles are stored as 8 bytes, strings as u8 length
+ * plus bytes. Encoding stops at the first argument that does not fit.
+ *
+ * @return Number of bytes written to out.
+ */
+unsigned int log_bin_encode_args(uint8_t *out, unsigned int size, const char *fmt, va_list args);
+
+/**
+ * @brief Renders fmt with arguments previously produced by log_bin_encode_args().
+ * @return Length written (excluding the terminating NUL), clamped to size - 1.
+ */
+size_t log_bin_render(char *out, size_t size, const char *fmt, const uint8_t *args, unsigned int args_len);
+
+#endif
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "logger_internal.h"
+
+#define LOG_MMAP_MIN_SEGMENT (64U * 1024U)
+#define LOG_MMAP_TRIM_CHUNK 4096
+
+/*
+ * Text file sink. The active segment is preallocated to segment_size and written
+ * through a shared mapping, so a log line costs a memcpy instead of a write().
+ * A full segment is truncated to its used length and rotated:
+ * file -> file.1 -> ... -> file.<max_segments - 1>, the oldest is overwritten.
+ * Logging threads only start writeback (MS_ASYNC); waiting for the disk (MS_SYNC)
+ * is left to log_mmap_sync() on the async worker and to the final close.
+ * If a rotation fails, lines are appended to the file with write() instead.
+ */
+static pthread_mutex_t mmap_lock = PTHREAD_MUTEX_INITIALIZER;
+static char base_name[PATH_MAX];
+static bool sink_open = false; /*---stays set while a segment rotates---*/
+static int segment_fd = -1;
+static char *segment_map = NULL;
+static size_t mapped_size = 0;
+static size_t segment_used = 0;
+static size_t segment_synced = 0;    /*---bytes known to be on disk---*/
+static size_t segment_scheduled = 0; /*---bytes handed to writeback with MS_ASYNC---*/
+static struct timespec last_sync;      /*---last MS_SYNC---*/
+static struct timespec last_writeback; /*---last MS_ASYNC---*/
+static int fallback_fd = -1; /*---plain appending descriptor after a failed rotation---*/
+
+static size_t segment_size = 1024U * 1024U;
+static unsigned int max_segments = 4U;
+static unsigned int sync_interval_ms = 1000U;
+
+void set_logger_file_limits(size_t segment_bytes, unsigned int segments, unsigned int sync_ms)
+{
+    if (segment_bytes < LOG_MMAP_MIN_SEGMENT || segments < 1U)
+    {
+        fprintf(stderr, "WARNING: Invalid log file limits %zu bytes x %u segments provided.\n", segment_bytes, segments);
+        return;
+    }
+
+    pthread_mutex_lock(&mmap_lock);
+    segment_size = segment_bytes;
+    max_segments = segments;
+    sync_interval_ms = sync_ms;
+    pthread_mutex_unlock(&mmap_lock);
+}
+
+/*---Cuts off the zero filled tail a crash leaves behind in a preallocated segment---*/
+static void trim_preallocated_tail(int fd)
+{
+    struct stat st;
+    char chunk[LOG_MMAP_TRIM_CHUNK];
+
+    if (fstat(fd, &st) != 0)
+    {
+        return;
+    }
+
+    off_t end = st.st_size;
+    while (end > 0)
+    {
+        off_t start = (end > (off_t)sizeof(chunk)) ? end - (off_t)sizeof(chunk) : 0;
+        ssize_t len = pread(fd, chunk, (size_t)(end - start), start);
+        if (len <= 0)
+        {
+            return;
+        }
+        while (len > 0 && chunk[len - 1] == '\0')
+        {
+            len--;
+        }
+        if (len > 0)
+        {
+            end = start + len;
+            break;
+        }
+        end = start;
+    }
+
+    if (end != st.st_size)
+    {
+        (void)ftruncate(fd, end);
+    }
+}
+
+static void segment_name(char *out, size_t size, unsigned int index)
+{
+    if (index == 0U)
+    {
+        snprintf(out, size, "%s", base_name);
+    }
+    else
+    {
+        snprintf(out, size, "%s.%u", base_name, index);
+    }
+}
+
+/*---Shifts file.<n> to file.<n + 1>, dropping everything past max_segments---*/
+static void shift_segments(void)
+{
+    char from[PATH_MAX + 16];
+    char to[PATH_MAX + 16];
+
+    if (max_segments == 1U)
+    {
+        unlink(base_name);
+        return;
+    }
+    for (unsigned int i = max_segments - 1U; i > 0U; --i)
+    {
+        segment_name(from, sizeof(from), i - 1U);
+        segment_name(to, sizeof(to), i);
+        rename(from, to);
+    }
+}
+
+static void sync_segment(int flags)
+{
+    // msync needs a page aligned start
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    bool wait = (flags & MS_SYNC) != 0;
+    size_t *done = wait ? &segment_synced : &segment_scheduled;
+    size_t start = *done & ~(page - 1U);
+
+    if (segment_used > *done)
+    {
+        msync(segment_map + start, segment_used - start, flags);
+        *done = segment_used;
+    }
+    clock_gettime(CLOCK_MONOTONIC, wait ? &last_sync : &last_writeback);
+}
+
+static void close_segment(int sync_flags)
+{
+    if (segment_map != NULL)
+    {
+        sync_segment(sync_flags);
+        munmap(segment_map, mapped_size);
+        segment_map = NULL;
+    }
+    if (segment_fd >= 0)
+    {
+        // Give back the unused preallocation
+        (void)ftruncate(segment_fd, (off_t)segment_used);
+        close(segment_fd);
+        segment_fd = -1;
+    }
+}
+
+static int open_segment(void)
+{
+    int fd = open(base_name, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    // Keep what an earlier run wrote in file.1
+    trim_preallocated_tail(fd);
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        close(fd);
+        shift_segments();
+        fd = open(base_name, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            return -1;
+        }
+    }
+
+    // Reserve the blocks up front, fall back to a sparse file where fallocate is unsupported
+    if (fallocate(fd, 0, 0, (off_t)segment_size) != 0 &&
+        (errno != EOPNOTSUPP || ftruncate(fd, (off_t)segment_size) != 0))
+    {
+        close(fd);
+        return -1;
+    }
+
+    char *map = mmap(NULL, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(fd);
+        return -1;
+    }
+
+    segment_fd = fd;
+    mapped_size = segment_size;
+    segment_used = 0;
+    segment_synced = 0;
+    segment_scheduled = 0;
+    segment_map = map;
+    clock_gettime(CLOCK_MONOTONIC, &last_sync);
+    last_writeback = last_sync;
+    return 0;
+}
+
+int log_mmap_open(const char *filename)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&mmap_lock);
+    if (!sink_open)
+    {
+        snprintf(base_name, sizeof(base_name), "%s", filename);
+        ret = open_segment();
+        __atomic_store_n(&sink_open, ret == 0, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&mmap_lock);
+    return ret;
+}
+
+void log_mmap_close(void)
+{
+    pthread_mutex_lock(&mmap_lock);
+    __atomic_store_n(&sink_open, false, __ATOMIC_RELEASE);
+    close_segment(MS_SYNC);
+    if (fallback_fd >= 0)
+    {
+        close(fallback_fd);
+        fallback_fd = -1;
+    }
+    pthread_mutex_unlock(&mmap_lock);
+}
+
+bool log_mmap_active(void)
+{
+    return __atomic_load_n(&sink_open, __ATOMIC_RELAXED);
+}
+
+static bool sync_due(const struct timespec *last)
+{
+    struct timespec now;
+    long long elapsed_ms;
+
+    if (sync_interval_ms == 0U)
+    {
+        return false;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    elapsed_ms = (long long)(now.tv_sec - last->tv_sec) * 1000LL + (now.tv_nsec - last->tv_nsec) / 1000000L;
+    return elapsed_ms >= (long long)sync_interval_ms;
+}
+
+/*---Called with mmap_lock held when the next segment cannot be mapped; false if the sink is lost---*/
+static bool fall_back_to_append(void)
+{
+    fallback_fd = open(base_name, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fallback_fd < 0)
+    {
+        fprintf(stderr, "ERROR: Could not rotate log file %s (%s), file logging disabled.\n", base_name,
+                strerror(errno));
+        __atomic_store_n(&sink_open, false, __ATOMIC_RELEASE);
+        return false;
+    }
+    fprintf(stderr, "ERROR: Could not rotate log file %s, appending without rotation.\n", base_name);
+    return true;
+}
+
+void log_mmap_write(const char *prefix, size_t prefix_len, const char *msg, size_t msg_len)
+{
+    size_t len = prefix_len + msg_len + 1U;
+    bool lost = false;
+
+    pthread_mutex_lock(&mmap_lock);
+    if (segment_map != NULL && segment_used + len > mapped_size)
+    {
+        close_segment(MS_ASYNC);
+        if (open_segment() != 0)
+        {
+            lost = !fall_back_to_append();
+        }
+    }
+    if (segment_map != NULL && segment_used + len <= mapped_size)
+    {
+        char *dst = segment_map + segment_used;
+        memcpy(dst, prefix, prefix_len);
+        memcpy(dst + prefix_len, msg, msg_len);
+        dst[prefix_len + msg_len] = '\n';
+        segment_used += len;
+
+        if (sync_due(&last_writeback))
+        {
+            sync_segment(MS_ASYNC);
+        }
+    }
+    else if (fallback_fd >= 0)
+    {
+        struct iovec line[3] = {{(void *)prefix, prefix_len}, {(void *)msg, msg_len}, {"\n", 1U}};
+        (void)writev(fallback_fd, line, 3);
+    }
+    pthread_mutex_unlock(&mmap_lock);
+
+    if (lost)
+    {
+        // Stop formatting lines for a file sink that is gone
+        log_update_gates();
+    }
+}
+
+void log_mmap_sync(void)
+{
+    pthread_mutex_lock(&mmap_lock);
+    if (segment_map != NULL && sync_due(&last_sync))
+    {
+        sync_segment(MS_SYNC);
+    }
+    pthread_mutex_unlock(&mmap_lock);
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "logger_internal.h"
+
+static uint64_t monotonic_coarse_ns(void)
+{
+    struct timespec now;
+    // Jiffy resolution is plenty for rate limiting and avoids reading the TSC
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+int log_ratelimit_allow(struct log_ratelimit *ratelimit, const struct log_site *site, DEBUG_LOG_LEVEL level)
+{
+    unsigned long long now = monotonic_coarse_ns();
+    unsigned long long tat = __atomic_load_n(&ratelimit->tat_ns, __ATOMIC_RELAXED);
+    unsigned long long next;
+
+    // Generic cell rate algorithm: conforming while the arrival time is no more than the burst tolerance ahead
+    do
+    {
+        if (tat > now + ratelimit->tolerance_ns)
+        {
+            __atomic_fetch_add(&ratelimit->suppressed, 1U, __ATOMIC_RELAXED);
+            return 0;
+        }
+        next = ((tat > now) ? tat : now) + ratelimit->interval_ns;
+    } while (!__atomic_compare_exchange_n(&ratelimit->tat_ns, &tat, next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    unsigned int suppressed = __atomic_exchange_n(&ratelimit->suppressed, 0U, __ATOMIC_RELAXED);
+    if (suppressed > 0U)
+    {
+        dbg_log(site->file, site->line, site->function, level, "%u messages suppressed by rate limit", suppressed);
+    }
+    return 1;
+}
+
+int log_sample_allow(struct log_sample *sample)
+{
+    unsigned long long n = __atomic_fetch_add(&sample->count, 1ULL, __ATOMIC_RELAXED);
+
+    if (n < sample->first)
+    {
+        return 1;
+    }
+    return sample->every != 0U && (n - sample->first + 1ULL) % sample->every == 0ULL;
+}
+
+/*
+ * Duplicate suppression: state of the last record that reached the sinks. Off by
+ * default, it serializes every synchronous write on dedup_lock. While enabled, a
+ * timer thread reports runs that stay pending because no further message arrives.
+ */
+static pthread_mutex_t dedup_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dedup_timer_wake = PTHREAD_COND_INITIALIZER;
+static pthread_t dedup_timer;
+static bool dedup_timer_running = false; /*---guarded by dedup_lock---*/
+static bool dedup_enabled = false;
+static bool have_last = false;
+static struct log_record last_record;
+static unsigned int repeats = 0;
+static uint64_t run_reported_ns = 0; /*---when the current run was last reported---*/
+
+static bool same_record(const struct log_record *a, const struct log_record *b)
+{
+    // Binary records compare their encoded arguments, text records their message
+    return a->site == b->site && a->file == b->file && a->line == b->line && a->level == b->level &&
+           a->msg_len == b->msg_len && memcmp(a->msg, b->msg, a->msg_len) == 0;
+}
+
+/*---Called with dedup_lock held---*/
+static void report_repeats(void)
+{
+    struct log_record summary;
+    int len;
+
+    summary.timestamp = last_record.timestamp;
+    summary.clock = last_record.clock;
+    summary.site = NULL;
+    summary.file = last_record.file;
+    summary.function = last_record.function;
+    summary.line = last_record.line;
+    summary.level = last_record.level;
+    len = snprintf(summary.msg, sizeof(summary.msg), "Last message repeated %u times", repeats);
+    summary.msg_len = (len < 0) ? 0U : (unsigned int)len;
+
+    log_write_sinks(&summary, true);
+    repeats = 0;
+    run_reported_ns = monotonic_coarse_ns();
+}
+
+static bool report_due(void)
+{
+    return repeats > 0U && monotonic_coarse_ns() - run_reported_ns >= LOG_DEDUP_REPORT_SEC * 1000000000ULL;
+}
+
+static void *dedup_timer_loop(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&dedup_lock);
+    while (dedup_timer_running)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += LOG_DEDUP_REPORT_SEC;
+        pthread_cond_timedwait(&dedup_timer_wake, &dedup_lock, &deadline);
+
+        if (report_due())
+        {
+            report_repeats();
+        }
+    }
+    pthread_mutex_unlock(&dedup_lock);
+    return NULL;
+}
+
+void set_log_dedup(int enable)
+{
+    bool join_timer = false;
+
+    pthread_mutex_lock(&dedup_lock);
+    if (repeats > 0U)
+    {
+        report_repeats();
+    }
+    __atomic_store_n(&dedup_enabled, enable != 0, __ATOMIC_RELAXED);
+    have_last = false;
+
+    if (enable != 0 && !dedup_timer_running)
+    {
+        dedup_timer_running = pthread_create(&dedup_timer, NULL, dedup_timer_loop, NULL) == 0;
+        if (!dedup_timer_running)
+        {
+            fprintf(stderr, "WARNING: Could not start log dedup timer, repeats are reported with the next message.\n");
+        }
+    }
+    else if (enable == 0 && dedup_timer_running)
+    {
+        dedup_timer_running = false;
+        pthread_cond_signal(&dedup_timer_wake);
+        join_timer = true;
+    }
+    pthread_mutex_unlock(&dedup_lock);
+
+    if (join_timer)
+    {
+        pthread_join(dedup_timer, NULL);
+    }
+}
+
+bool log_dedup_suppress(const struct log_record *rec)
+{
+    if (!__atomic_load_n(&dedup_enabled, __ATOMIC_RELAXED))
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&dedup_lock);
+    if (have_last && same_record(rec, &last_record))
+    {
+        uint64_t now = monotonic_coarse_ns();
+
+        if (repeats++ == 0U)
+        {
+            run_reported_ns = now;
+        }
+        last_record.timestamp = rec->timestamp;
+        if (now - run_reported_ns >= LOG_DEDUP_REPORT_SEC * 1000000000ULL)
+        {
+            report_repeats();
+        }
+        pthread_mutex_unlock(&dedup_lock);
+        return true;
+    }
+
+    if (repeats > 0U)
+    {
+        report_repeats();
+    }
+    memcpy(&last_record, rec, offsetof(struct log_record, msg) + rec->msg_len);
+    have_last = true;
+    pthread_mutex_unlock(&dedup_lock);
+    return false;
+}
+
+void log_dedup_flush(bool force)
+{
+    pthread_mutex_lock(&dedup_lock);
+    if (repeats > 0U && (force || report_due()))
+    {
+        report_repeats();
+    }
+    pthread_mutex_unlock(&dedup_lock);
+}
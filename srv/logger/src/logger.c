@@ -16,30 +16,61 @@
 
 
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <time.h>
 
 #include "logger.h"
+#include "logger_internal.h"
+#include "log_format.h"
 
-void init_logger_file(const char *filename)
+static DEBUG_LOG_LEVEL console_log_threshold = DEBUG_INFO; /*---show on console---*/
+static DEBUG_LOG_LEVEL file_log_threshold = DEBUG_TRACE;   /*---write to file---*/
+static DEBUG_LOG_LEVEL module_log_threshold[LOG_MAX_MODULES];  /*---per module, DEBUG_TRACE = no restriction---*/
+static LOG_CLOCK timestamp_clock = LOG_CLOCK_REALTIME;
+
+/*---Initially only the console sink (DEBUG_INFO) is active---*/
+unsigned char log_level_gate[LOG_MAX_MODULES] = {
+    DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO,
+    DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO, DEBUG_INFO};
+
+void log_update_gates(void)
 {
-    if (log_file == NULL)
+    DEBUG_LOG_LEVEL sink_min = console_log_threshold;
+
+    if ((log_mmap_active() || log_binary_active()) && file_log_threshold < sink_min)
     {
-        log_file = fopen(filename, "a");
-        if (log_file == NULL)
-        {
-            fprintf(stderr, "ERROR: Could not open log file: %s\n", filename);
-        }
+        sink_min = file_log_threshold;
+    }
+    if (log_flight_active())
+    {
+        sink_min = DEBUG_TRACE;
+    }
+
+    for (int module = 0; module < LOG_MAX_MODULES; ++module)
+    {
+        DEBUG_LOG_LEVEL gate = (module_log_threshold[module] > sink_min) ? module_log_threshold[module] : sink_min;
+        __atomic_store_n(&log_level_gate[module], (unsigned char)gate, __ATOMIC_RELAXED);
     }
 }
 
-void close_logger_file()
+void init_logger_file(const char *filename)
 {
-    if (log_file != NULL)
+    if (log_mmap_open(filename) != 0)
     {
-        fclose(log_file);
-        log_file = NULL;
+        fprintf(stderr, "ERROR: Could not open log file: %s\n", filename);
     }
+    log_update_gates();
+}
+
+void close_logger_file()
+{
+    // Drain queued records while the file is still open
+    stop_async_logger();
+    log_dedup_flush(true);
+
+    log_mmap_close();
+    log_update_gates();
 }
 
 void set_console_log_threshold(DEBUG_LOG_LEVEL level)
@@ -47,6 +78,7 @@ void set_console_log_threshold(DEBUG_LOG_LEVEL level)
     if (level >= DEBUG_TRACE && level <= DEBUG_CRITICAL)
     {
         console_log_threshold = level;
+        log_update_gates();
         fprintf(stderr, "Console log threshold set to level %d\n", level);
     }
     else
@@ -60,10 +92,12 @@ void set_file_log_threshold(DEBUG_LOG_LEVEL level)
     if (level >= DEBUG_TRACE && level <= DEBUG_CRITICAL)
     {
         file_log_threshold = level;
-        if (log_file != NULL)
+        log_update_gates();
+        if (log_mmap_active())
         {
-            fprintf(log_file, "File log threshold set to level %d\n", level);
-            fflush(log_file);
+            char text[64];
+            int len = snprintf(text, sizeof(text), "File log threshold set to level %d", level);
+            log_mmap_write(text, (size_t)len, "", 0);
         }
     }
     else
@@ -72,45 +106,180 @@ void set_file_log_threshold(DEBUG_LOG_LEVEL level)
     }
 }
 
-void dbg_log(const char *file, int line, const char *function, DEBUG_LOG_LEVEL level, const char *fmtstr, ...)
+void set_module_log_threshold(LOG_MODULE_ID module, DEBUG_LOG_LEVEL level)
 {
-    va_list args_console; /*---for console log---*/
-    va_list args_file;    /*---for file log---*/
+    if (module >= LOG_MODULE_DEFAULT && module < LOG_MAX_MODULES && level >= DEBUG_TRACE && level <= DEBUG_CRITICAL)
+    {
+        module_log_threshold[module] = level;
+        log_update_gates();
+    }
+    else
+    {
+        fprintf(stderr, "WARNING: Invalid module %d or log threshold level %d provided.\n", module, level);
+    }
+}
 
-    /*--- Get current time for timestamp ---*/
-    time_t current_time;
-    struct tm *local_time_info;
-    char timestamp_buffer[30]; /*---Sufficient buffer for timestamp like "YYYY-MM-DD HH:MM:SS"---*/
+void set_log_timestamp_clock(LOG_CLOCK clock)
+{
+    if (clock == LOG_CLOCK_REALTIME || clock == LOG_CLOCK_MONOTONIC)
+    {
+        timestamp_clock = clock;
+    }
+    else
+    {
+        fprintf(stderr, "WARNING: Invalid log timestamp clock %d provided.\n", clock);
+    }
+}
 
-    time(&current_time);
-    local_time_info = localtime(&current_time);
+int log_timestamp_clock(void)
+{
+    return (timestamp_clock == LOG_CLOCK_MONOTONIC) ? LOG_TS_MONOTONIC : LOG_TS_REALTIME;
+}
 
-    /*---Format the timestamp---*/
-    strftime(timestamp_buffer, sizeof(timestamp_buffer), "%Y-%m-%d %H:%M:%S", local_time_info);
+void log_fill_record(struct log_record *rec, struct log_site *site, const char *file, int line, const char *function,
+                     DEBUG_LOG_LEVEL level, const char *fmtstr, va_list args)
+{
+    va_list args_copy;
 
-    /*---Prepare common log message prefix---*/
+    /*---vDSO call, no lock and no localtime() on the caller's thread---*/
+    if (timestamp_clock == LOG_CLOCK_MONOTONIC)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &rec->timestamp);
+        rec->clock = LOG_TS_MONOTONIC;
+    }
+    else
+    {
+        clock_gettime(CLOCK_REALTIME, &rec->timestamp);
+        rec->clock = LOG_TS_REALTIME;
+    }
+    rec->file = file;
+    rec->line = line;
+    rec->function = function;
+    rec->level = level;
+
+    va_copy(args_copy, args);
+    if (site != NULL && log_binary_active() && log_binary_register_site(site, fmtstr) == 0)
+    {
+        /*---Binary: keep the raw arguments, formatting is deferred---*/
+        rec->site = site;
+        rec->msg_len = log_bin_encode_args((uint8_t *)rec->msg, sizeof(rec->msg), fmtstr, args_copy);
+    }
+    else
+    {
+        int len = vsnprintf(rec->msg, sizeof(rec->msg), fmtstr, args_copy);
+        rec->site = NULL;
+        rec->msg_len = (len < 0) ? 0U : ((size_t)len >= sizeof(rec->msg) ? sizeof(rec->msg) - 1 : (unsigned int)len);
+    }
+    va_end(args_copy);
+}
+
+void log_write_record(const struct log_record *rec, bool flush)
+{
+    if (!log_dedup_suppress(rec))
+    {
+        log_write_sinks(rec, flush);
+    }
+}
+
+void log_write_sinks(const struct log_record *rec, bool flush)
+{
     char prefix_buffer[512];
-    snprintf(prefix_buffer, sizeof(prefix_buffer), "[%s] [%s:%d] %s() [Level:%d]: ",
-             timestamp_buffer, file, line, function, level);
+    char text_buffer[1024];
+    const char *msg = rec->msg;
+    size_t msg_len = rec->msg_len;
+    bool to_console = rec->level >= console_log_threshold;
+    bool to_file = rec->level >= file_log_threshold && log_mmap_active();
+
+    /*--- Binary Sink ---*/
+    if (rec->level >= file_log_threshold && log_binary_active())
+    {
+        if (rec->site != NULL)
+        {
+            log_binary_write_record(rec, flush);
+        }
+        else
+        {
+            log_binary_write_text(rec, flush);
+        }
+    }
+
+    if (!to_console && !to_file)
+    {
+        return;
+    }
+
+    /*---Deferred formatting of binary records for the text sinks---*/
+    if (rec->site != NULL)
+    {
+        msg_len = log_bin_render(text_buffer, sizeof(text_buffer), rec->site->fmt, (const uint8_t *)rec->msg, rec->msg_len);
+        msg = text_buffer;
+    }
+
+    /*---Prepare common log message prefix---*/
+    size_t prefix_len = log_format_prefix(prefix_buffer, sizeof(prefix_buffer), &rec->timestamp, rec->clock,
+                                          rec->file, rec->line, rec->function, rec->level);
 
     /*--- Console Sink ---*/
-    if (level >= console_log_threshold)
+    if (to_console)
     {
-        va_start(args_console, fmtstr);
-        fprintf(stderr, "%s", prefix_buffer);
-        vfprintf(stderr, fmtstr, args_console);
-        fprintf(stderr, "\n");
-        va_end(args_console);
+        fwrite(prefix_buffer, 1, prefix_len, stderr);
+        fwrite(msg, 1, msg_len, stderr);
+        fputc('\n', stderr);
     }
 
     /*--- File Sink ---*/
-    if (log_file != NULL && level >= file_log_threshold)
+    if (to_file)
     {
-        va_start(args_file, fmtstr);
-        fprintf(log_file, "%s", prefix_buffer);
-        vfprintf(log_file, fmtstr, args_file);
-        fprintf(log_file, "\n");
-        fflush(log_file);
-        va_end(args_file);
+        // No flush needed: the mapped pages are in the page cache as soon as they are copied
+        log_mmap_write(prefix_buffer, prefix_len, msg, msg_len);
     }
-}
\ No newline at end of file
+}
+
+void log_flush_sinks(void)
+{
+    log_dedup_flush(false);
+    log_mmap_sync();
+}
+
+static void log_dispatch(struct log_site *site, const char *file, int line, const char *function,
+                         DEBUG_LOG_LEVEL level, const char *fmtstr, va_list args)
+{
+    /*--- Flight recorder: every level, independent of the sinks ---*/
+    if (log_flight_active())
+    {
+        log_flight_record(site, file, line, function, level, fmtstr, args);
+    }
+
+    /*---Nothing to do if no sink wants this level---*/
+    if (level < console_log_threshold &&
+        ((!log_mmap_active() && !log_binary_active()) || level < file_log_threshold))
+    {
+        return;
+    }
+
+    /*--- Async mode: hand the record to the background thread ---*/
+    if (log_async_enqueue(site, file, line, function, level, fmtstr, args) != 0)
+    {
+        struct log_record rec;
+        log_fill_record(&rec, site, file, line, function, level, fmtstr, args);
+        log_write_record(&rec, true);
+    }
+}
+
+void dbg_log(const char *file, int line, const char *function, DEBUG_LOG_LEVEL level, const char *fmtstr, ...)
+{
+    va_list args;
+
+    va_start(args, fmtstr);
+    log_dispatch(NULL, file, line, function, level, fmtstr, args);
+    va_end(args);
+}
+
+void dbg_log_site(struct log_site *site, DEBUG_LOG_LEVEL level, const char *fmtstr, ...)
+{
+    va_list args;
+
+    va_start(args, fmtstr);
+    log_dispatch(site, site->file, site->line, site->function, level, fmtstr, args);
+    va_end(args);
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef LOGGER_INTERNAL_H
+#define LOGGER_INTERNAL_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "logger.h"
+
+#define LOG_RECORD_MSG_MAX 200 /*---message body bytes kept per record, longer messages are truncated---*/
+#define LOG_DEDUP_REPORT_SEC 1 /*---longest a run of repeated messages stays unreported---*/
+
+/*
+ * One log statement, captured at the call site and rendered by log_write_record().
+ * If site is set, msg holds the arguments encoded by log_bin_encode_args() instead of text.
+ */
+struct log_record
+{
+    struct timespec timestamp;
+    int clock; /*---LOG_TS_REALTIME or LOG_TS_MONOTONIC---*/
+    const struct log_site *site;
+    const char *file;
+    const char *function;
+    int line;
+    DEBUG_LOG_LEVEL level;
+    unsigned int msg_len;
+    char msg[LOG_RECORD_MSG_MAX];
+};
+
+/*---Recomputes log_level_gate after any threshold or sink change---*/
+void log_update_gates(void);
+
+/*---Captures the call into rec: binary encoded arguments if a binary file is open and the site is known, text otherwise---*/
+void log_fill_record(struct log_record *rec, struct log_site *site, const char *file, int line, const char *function,
+                     DEBUG_LOG_LEVEL level, const char *fmtstr, va_list args);
+
+/*---Writes the record unless it repeats the previous one (see log_dedup_suppress)---*/
+void log_write_record(const struct log_record *rec, bool flush);
+
+/*---Formats the prefix and writes the record to every sink whose threshold it passes---*/
+void log_write_sinks(const struct log_record *rec, bool flush);
+
+/*---Flushes the stdio sinks and syncs the mapped file if its interval elapsed---*/
+void log_flush_sinks(void);
+
+/*---Queues the record on the calling thread's ring. Returns 0 if consumed (queued or dropped), -1 if the caller must log synchronously---*/
+int log_async_enqueue(struct log_site *site, const char *file, int line, const char *function, DEBUG_LOG_LEVEL level,
+                      const char *fmtstr, va_list args);
+
+/*
+ * Duplicate suppression (log_ratelimit.c), enabled with set_log_dedup(). Returns
+ * true if rec repeats the previous record and must not be written. Runs of
+ * repeats are reported as "Last message repeated N times" when they end, at
+ * least once per LOG_DEDUP_REPORT_SEC (by a timer thread if nothing else is
+ * logged) and when flushed with force.
+ */
+bool log_dedup_suppress(const struct log_record *rec);
+void log_dedup_flush(bool force);
+
+/*---Clock used for new records (LOG_TS_*)---*/
+int log_timestamp_clock(void);
+
+/*---Memory mapped, rotating text file sink (log_mmap.c)---*/
+int log_mmap_open(const char *filename);
+void log_mmap_close(void);
+bool log_mmap_active(void);
+void log_mmap_write(const char *prefix, size_t prefix_len, const char *msg, size_t msg_len);
+void log_mmap_sync(void);
+
+/*---Flight recorder (log_flight.c), records every call that passes the module threshold---*/
+bool log_flight_active(void);
+void log_flight_record(struct log_site *site, const char *file, int line, const char *function, DEBUG_LOG_LEVEL level,
+                       const char *fmtstr, va_list args);
+
+/*---Binary sink (log_binary.c)---*/
+bool log_binary_active(void);
+int log_binary_register_site(struct log_site *site, const char *fmtstr);
+void log_binary_write_record(const struct log_record *rec, bool flush);
+void log_binary_write_text(const struct log_record *rec, bool flush);
+void log_binary_flush(void);
+
+#endif
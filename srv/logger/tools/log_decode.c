@@ -0,0 +1,263 @@
+/*
+ * Copyright 2024 Kamlesh Singh
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "log_format.h"
+
+struct site_entry
+{
+    char *file;
+    char *function;
+    char *fmt;
+    int line;
+};
+
+/*---Sites of the current session, indexed by site ID---*/
+static struct site_entry *sites = NULL;
+static size_t num_sites = 0;
+static int session_clock = LOG_TS_REALTIME;
+
+static void reset_sites(void)
+{
+    for (size_t i = 0; i < num_sites; ++i)
+    {
+        free(sites[i].file);
+        free(sites[i].function);
+        free(sites[i].fmt);
+    }
+    free(sites);
+    sites = NULL;
+    num_sites = 0;
+}
+
+static int read_exact(FILE *in, void *buf, size_t len)
+{
+    return (fread(buf, 1, len, in) == len) ? 0 : -1;
+}
+
+static char *read_string(FILE *in, uint16_t len)
+{
+    char *str = malloc((size_t)len + 1U);
+    if (str == NULL || read_exact(in, str, len) != 0)
+    {
+        free(str);
+        return NULL;
+    }
+    str[len] = '\0';
+    return str;
+}
+
+static void ns_to_timespec(uint64_t ns, struct timespec *ts)
+{
+    ts->tv_sec = (time_t)(ns / 1000000000ULL);
+    ts->tv_nsec = (long)(ns % 1000000000ULL);
+}
+
+static int read_header(FILE *in)
+{
+    char magic[LOG_BIN_MAGIC_LEN];
+    uint32_t endian;
+    uint32_t clock;
+
+    if (read_exact(in, magic, sizeof(magic)) != 0 || memcmp(magic, LOG_BIN_MAGIC, LOG_BIN_MAGIC_LEN) != 0 ||
+        read_exact(in, &endian, sizeof(endian)) != 0 || read_exact(in, &clock, sizeof(clock)) != 0)
+    {
+        fprintf(stderr, "ERROR: Not a binary log file.\n");
+        return -1;
+    }
+    if (endian != LOG_BIN_ENDIAN_MARK)
+    {
+        fprintf(stderr, "ERROR: Binary log was written with a different byte order.\n");
+        return -1;
+    }
+    session_clock = (int)clock;
+    return 0;
+}
+
+static int decode_site(FILE *in)
+{
+    uint32_t id;
+    uint32_t line;
+    uint16_t file_len;
+    uint16_t func_len;
+    uint16_t fmt_len;
+
+    if (read_exact(in, &id, sizeof(id)) != 0 || read_exact(in, &line, sizeof(line)) != 0 ||
+        read_exact(in, &file_len, sizeof(file_len)) != 0 || read_exact(in, &func_len, sizeof(func_len)) != 0 ||
+        read_exact(in, &fmt_len, sizeof(fmt_len)) != 0)
+    {
+        return -1;
+    }
+
+    if (id >= num_sites)
+    {
+        size_t new_size = (size_t)id + 64U;
+        struct site_entry *grown = realloc(sites, new_size * sizeof(*sites));
+        if (grown == NULL)
+        {
+            return -1;
+        }
+        memset(grown + num_sites, 0, (new_size - num_sites) * sizeof(*sites));
+        sites = grown;
+        num_sites = new_size;
+    }
+
+    struct site_entry *site = &sites[id];
+    free(site->file);
+    free(site->function);
+    free(site->fmt);
+    site->line = (int)line;
+    site->file = read_string(in, file_len);
+    site->function = read_string(in, func_len);
+    site->fmt = read_string(in, fmt_len);
+    return (site->file && site->function && site->fmt) ? 0 : -1;
+}
+
+static int decode_record(FILE *in)
+{
+    uint32_t id;
+    uint8_t level;
+    uint64_t ns;
+    uint16_t args_len;
+    uint8_t args[UINT16_MAX];
+    char prefix[512];
+    char text[4096];
+    struct timespec ts;
+
+    if (read_exact(in, &id, sizeof(id)) != 0 || read_exact(in, &level, sizeof(level)) != 0 ||
+        read_exact(in, &ns, sizeof(ns)) != 0 || read_exact(in, &args_len, sizeof(args_len)) != 0 ||
+        read_exact(in, args, args_len) != 0)
+    {
+        return -1;
+    }
+
+    if (id >= num_sites || sites[id].fmt == NULL)
+    {
+        fprintf(stderr, "WARNING: Record references unknown site %u, skipped.\n", id);
+        return 0;
+    }
+
+    ns_to_timespec(ns, &ts);
+    log_format_prefix(prefix, sizeof(prefix), &ts, session_clock, sites[id].file, sites[id].line, sites[id].function,
+                      level);
+    log_bin_render(text, sizeof(text), sites[id].fmt, args, args_len);
+    printf("%s%s\n", prefix, text);
+    return 0;
+}
+
+static int decode_text(FILE *in)
+{
+    uint8_t level;
+    uint64_t ns;
+    uint32_t line;
+    uint16_t file_len;
+    uint16_t func_len;
+    uint16_t msg_len;
+    char prefix[512];
+    struct timespec ts;
+
+    if (read_exact(in, &level, sizeof(level)) != 0 || read_exact(in, &ns, sizeof(ns)) != 0 ||
+        read_exact(in, &line, sizeof(line)) != 0 || read_exact(in, &file_len, sizeof(file_len)) != 0 ||
+        read_exact(in, &func_len, sizeof(func_len)) != 0 || read_exact(in, &msg_len, sizeof(msg_len)) != 0)
+    {
+        return -1;
+    }
+
+    char *file = read_string(in, file_len);
+    char *function = read_string(in, func_len);
+    char *msg = read_string(in, msg_len);
+    int ret = -1;
+
+    if (file && function && msg)
+    {
+        ns_to_timespec(ns, &ts);
+        log_format_prefix(prefix, sizeof(prefix), &ts, session_clock, file, (int)line, function, level);
+        printf("%s%s\n", prefix, msg);
+        ret = 0;
+    }
+    free(file);
+    free(function);
+    free(msg);
+    return ret;
+}
+
+/**
+ * @brief Host side decoder for binary logs written by init_binary_logger_file().
+ *
+ * Prints every record as the text line the logger would have produced.
+ * Files holding several sessions (appended across restarts) are supported.
+ *
+ * Usage: log_decode <binary log file>
+ */
+int main(int argc, char **argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <binary log file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *in = fopen(argv[1], "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "ERROR: Could not open binary log file: %s\n", argv[1]);
+        return 1;
+    }
+
+    int ret = read_header(in);
+    int type;
+    while (ret == 0 && (type = fgetc(in)) != EOF)
+    {
+        switch (type)
+        {
+        case LOG_BIN_SITE:
+            ret = decode_site(in);
+            break;
+        case LOG_BIN_RECORD:
+            ret = decode_record(in);
+            break;
+        case LOG_BIN_TEXT:
+            ret = decode_text(in);
+            break;
+        case 'O': /*---first byte of LOG_BIN_MAGIC---*/
+            // Next session appended to the same file, site IDs start over
+            ungetc(type, in);
+            reset_sites();
+            ret = read_header(in);
+            break;
+        default:
+            fprintf(stderr, "ERROR: Unknown record type %d.\n", type);
+            ret = -1;
+            break;
+        }
+    }
+
+    // A record cut short at the end of the file is expected after a crash
+    int truncated_tail = (ret != 0 && feof(in));
+    if (ret != 0 && !truncated_tail)
+    {
+        fprintf(stderr, "ERROR: Corrupt binary log file.\n");
+    }
+    reset_sites();
+    fclose(in);
+    return (ret == 0 || truncated_tail) ? 0 : 1;
+}